@@ -0,0 +1,120 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef __colored_elem_range_h__
+#define __colored_elem_range_h__
+
+// Local Includes -----------------------------------
+#include "libmesh_common.h"
+#include "elem_range.h"
+
+// C++ Includes   -----------------------------------
+#include <vector>
+
+namespace libMesh
+{
+
+// Forward Declarations
+class DofMap;
+class MeshBase;
+
+
+/**
+ * This class splits the active local elements of a mesh into colors,
+ * so that no two elements of one color share a degree of freedom.
+ * The dofs an element adds to include the dependencies of its
+ * constrained dofs.  The elements of one color can then add their
+ * contributions to a global matrix or vector on multiple threads
+ * without locking, one color after the other:
+ *
+ * \verbatim
+ *   for (unsigned int c=0; c != colors.n_colors(); ++c)
+ *     Threads::parallel_for (colors.range(c), body);
+ * \endverbatim
+ *
+ * The coloring is greedy, in the order of the elements.  Use
+ * \p DofMap::colored_elem_range() to get one which is kept until
+ * the dofs change.
+ */
+
+// ------------------------------------------------------------
+// ColoredElemRange class definition
+class ColoredElemRange
+{
+public:
+
+  /**
+   * Constructor.  Creates an empty coloring.
+   */
+  ColoredElemRange ();
+
+  /**
+   * Colors the active local elements of \p mesh, using the degrees of
+   * freedom and constraints of \p dof_map.
+   */
+  void build (const MeshBase& mesh,
+	      const DofMap& dof_map);
+
+  /**
+   * Deletes the coloring.
+   */
+  void clear ();
+
+  /**
+   * @returns true if the coloring has been built.
+   */
+  bool built () const { return _built; }
+
+  /**
+   * @returns the number of colors.
+   */
+  unsigned int n_colors () const { return _colors.size(); }
+
+  /**
+   * @returns the number of elements of color \p c.
+   */
+  unsigned int n_elem (const unsigned int c) const
+  { libmesh_assert (c < _colors.size()); return _colors[c].size(); }
+
+  /**
+   * @returns a range over the elements of color \p c, for use with
+   * \p Threads::parallel_for().  The same range is reset by each
+   * call, so one color is worked on at a time.
+   */
+  ConstElemRange& range (const unsigned int c);
+
+private:
+
+  /**
+   * The elements of each color, in mesh order.
+   */
+  std::vector<std::vector<const Elem*> > _colors;
+
+  /**
+   * The range over the current color.
+   */
+  ConstElemRange _range;
+
+  bool _built;
+};
+
+
+} // namespace libMesh
+
+#endif // __colored_elem_range_h__
@@ -0,0 +1,164 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef __dof_constraint_cache_h__
+#define __dof_constraint_cache_h__
+
+// Local Includes -----------------------------------
+#include "libmesh_common.h"
+
+// C++ Includes   -----------------------------------
+#include <cstddef>
+#include <vector>
+
+namespace libMesh
+{
+
+// Forward Declarations
+class DofObject;
+class Elem;
+
+
+/**
+ * This class keeps the hanging node constraints computed on each
+ * element during one \p DofMap::create_dof_constraints(), so that the
+ * next call only has to recompute them on elements whose
+ * neighborhood has changed.  It is used when incremental constraints
+ * are enabled with \p DofMap::enable_incremental_constraints().
+ *
+ * The constraints of an element depend on the element, its parent and
+ * its side neighbors.  Each record stores a signature of that
+ * neighborhood, and the constraint rows in terms of the components of
+ * the \p DofObject s in it (the element, its parent, its neighbors and
+ * all their nodes, see \p neighborhood()) instead of global dof
+ * indices, which change with every \p distribute_dofs().  A record is
+ * reused as long as the signature of the element is unchanged.
+ */
+
+// ------------------------------------------------------------
+// DofConstraintCache class definition
+class DofConstraintCache
+{
+public:
+
+  /**
+   * A constraint coefficient on component \p comp of the object in
+   * position \p slot of the neighborhood.
+   */
+  struct Entry
+  {
+    unsigned int slot;
+    unsigned int comp;
+    Real coef;
+  };
+
+  /**
+   * A constraint row of variable \p var, constraining component
+   * \p comp of the object in position \p slot of the neighborhood, in
+   * terms of the entries [ \p begin, \p end ).
+   */
+  struct Row
+  {
+    unsigned int var;
+    unsigned int slot;
+    unsigned int comp;
+    unsigned int begin;
+    unsigned int end;
+  };
+
+  /**
+   * The cached constraints of one element.
+   */
+  struct Record
+  {
+    Record () : valid(false) {}
+
+    std::vector<std::size_t> signature;
+    std::vector<Row>         rows;
+    std::vector<Entry>       entries;
+
+    /**
+     * Whether \p rows and \p entries may be reused.  False for new
+     * elements, and for constraints which could not be expressed in
+     * terms of the neighborhood.
+     */
+    bool valid;
+  };
+
+  /**
+   * Constructor.  Creates an empty cache.
+   */
+  DofConstraintCache ();
+
+  /**
+   * Deletes all the records.
+   */
+  void clear ();
+
+  /**
+   * Prepares the cache for a mesh whose element ids are below
+   * \p max_elem_id and a system with \p n_vars variables.  Records
+   * are kept unless the number of variables has changed.
+   */
+  void resize (const unsigned int max_elem_id,
+	       const unsigned int n_vars);
+
+  /**
+   * @returns the record of the element with id \p id.  Threads may
+   * access the records of different elements concurrently.
+   */
+  Record& record (const unsigned int id) { return _records[id]; }
+
+  /**
+   * Fills \p objects with the \p DofObject s whose degrees of freedom
+   * the constraints of \p elem are expressed in: \p elem, its nodes,
+   * its parent and the parent's nodes, and each side neighbor and its
+   * nodes.  Missing parents and neighbors take no positions, so the
+   * positions only agree between elements with equal signatures.
+   */
+  static void neighborhood (const Elem* elem,
+			    std::vector<const DofObject*>& objects);
+
+  /**
+   * Fills \p signature with the data that the constraints of \p elem
+   * depend on: the identity, level and refinement state of \p elem,
+   * its parent, and its side neighbors, and the number of components
+   * of system \p sys_num on each of the neighborhood \p objects.
+   */
+  static void signature (const Elem* elem,
+			 const std::vector<const DofObject*>& objects,
+			 const unsigned int sys_num,
+			 std::vector<std::size_t>& signature);
+
+  /**
+   * @returns the number of bytes used by the records.
+   */
+  std::size_t memory_usage () const;
+
+private:
+
+  std::vector<Record> _records;
+
+  unsigned int _n_vars;
+};
+
+
+} // namespace libMesh
+
+#endif // __dof_constraint_cache_h__
@@ -22,6 +22,10 @@
 
 // Local Includes -----------------------------------
 #include "libmesh_common.h"
+#include "auto_ptr.h"
+#include "colored_elem_range.h"
+#include "dof_constraint_cache.h" // AutoPtr needs a real declaration
+#include "dof_renumbering.h" // AutoPtr needs a real declaration
 #include "enum_order.h"
 #include "reference_counted_object.h"
 #include "libmesh.h" // libMesh::invalid_uint
@@ -97,6 +101,114 @@ class DofConstraints : public std::map<unsigned int,
 {
 };
 
+/**
+ * A read-only copy of a \p DofConstraints object, built by
+ * \p DofMap::process_constraints() once every constraint row has been
+ * expanded in terms of unconstrained dofs.  The rows are sorted by
+ * constrained dof and stored in compressed sparse row format: row \p r
+ * constrains \p dof(r) in terms of the dofs \p col(k) with coefficients
+ * \p coef(k) for \p k in [ \p row_begin(r), \p row_end(r) ), with
+ * right-hand side \p rhs(r).  A bitset over the local dofs answers
+ * membership queries for them in constant time.
+ */
+class PackedDofConstraints
+{
+public:
+
+  /**
+   * Constructor.  Creates an empty, unbuilt object.
+   */
+  PackedDofConstraints () : _first_dof(0), _built(false) {}
+
+  /**
+   * Discards any existing data and packs \p constraints.  The dofs in
+   * [ \p first_dof, \p end_dof ) are the local dofs.
+   */
+  void build (const DofConstraints& constraints,
+	      const unsigned int first_dof,
+	      const unsigned int end_dof);
+
+  /**
+   * Deletes all the data that are currently stored.
+   */
+  void clear ();
+
+  /**
+   * @returns true if \p build() has been called since the last
+   * \p clear().
+   */
+  bool built () const { return _built; }
+
+  /**
+   * @returns true if \p dof is constrained.
+   */
+  bool is_constrained (const unsigned int dof) const
+  {
+    if (dof - _first_dof < _local.size())
+      return _local[dof - _first_dof];
+
+    return std::binary_search (_dofs.begin(), _dofs.end(), dof);
+  }
+
+  /**
+   * @returns the row which constrains \p dof, or
+   * \p libMesh::invalid_uint if \p dof is not constrained.
+   */
+  unsigned int find (const unsigned int dof) const
+  {
+    if (dof - _first_dof < _local.size() && !_local[dof - _first_dof])
+      return libMesh::invalid_uint;
+
+    const std::vector<unsigned int>::const_iterator
+      pos = std::lower_bound (_dofs.begin(), _dofs.end(), dof);
+
+    if (pos == _dofs.end() || *pos != dof)
+      return libMesh::invalid_uint;
+
+    return std::distance (_dofs.begin(), pos);
+  }
+
+  /**
+   * @returns the number of constraint rows.
+   */
+  unsigned int n_rows () const { return _dofs.size(); }
+
+  /**
+   * Accessors for the data of row \p r.
+   */
+  unsigned int dof (const unsigned int r) const { return _dofs[r]; }
+  unsigned int row_begin (const unsigned int r) const { return _offsets[r]; }
+  unsigned int row_end (const unsigned int r) const { return _offsets[r+1]; }
+  Number rhs (const unsigned int r) const { return _rhs[r]; }
+
+  /**
+   * Accessors for entry \p k of the column and coefficient arrays.
+   */
+  unsigned int col (const unsigned int k) const { return _cols[k]; }
+  Real coef (const unsigned int k) const { return _coefs[k]; }
+
+  /**
+   * @returns the number of bytes used by the stored arrays.
+   */
+  std::size_t memory_usage () const;
+
+private:
+
+  std::vector<unsigned int> _dofs;
+  std::vector<unsigned int> _offsets;
+  std::vector<unsigned int> _cols;
+  std::vector<Real>         _coefs;
+  std::vector<Number>       _rhs;
+
+  /**
+   * One bit per local dof, set for the constrained ones.
+   */
+  std::vector<bool> _local;
+  unsigned int _first_dof;
+
+  bool _built;
+};
+
 #ifdef LIBMESH_ENABLE_NODE_CONSTRAINTS
 /**
  * A row of the Node constraint mapping.  Currently this just
@@ -154,6 +266,33 @@ public:
    */
   ~DofMap();
 
+  /**
+   * A read-only view of a contiguous block of global degree of
+   * freedom indices, which stays valid until the \p DofMap is
+   * reinitialized.
+   */
+  class IndexBlock
+  {
+  public:
+    IndexBlock () : _begin(NULL), _size(0) {}
+
+    IndexBlock (const unsigned int* begin_in,
+		const unsigned int size_in) :
+      _begin(begin_in), _size(size_in) {}
+
+    const unsigned int* begin () const { return _begin; }
+    const unsigned int* end () const { return _begin + _size; }
+    unsigned int size () const { return _size; }
+    bool empty () const { return _size == 0; }
+
+    unsigned int operator[] (const unsigned int i) const
+    { libmesh_assert (i < _size); return _begin[i]; }
+
+  private:
+    const unsigned int* _begin;
+    unsigned int _size;
+  };
+
   /**
    * Abstract base class to be used to add user-defined implicit
    * degree of freedom couplings.
@@ -200,6 +339,15 @@ public:
    */
   void distribute_dofs (MeshBase&);
 
+  /**
+   * A renumbering of the local degrees of freedom to apply at the end
+   * of each \p distribute_dofs(), or \p NULL (the default) to keep
+   * the mesh iteration order.  Can also be selected with the
+   * \p --dof-renumbering=rcm or \p --dof-renumbering=hilbert command
+   * line options.
+   */
+  AutoPtr<DofRenumbering> &dof_renumbering() { return _dof_renumbering; }
+
   /**
    * Computes the sparsity pattern for the matrix corresponding
    * to \p proc_id.  Produces data that can be fed to Petsc for
@@ -207,6 +355,32 @@ public:
    */
   void compute_sparsity (const MeshBase&);
 
+  /**
+   * Selects the \p SparsityPattern::CSRBuild builder in
+   * \p compute_sparsity(), which avoids the per-row allocations of
+   * the default builder on large problems.  The resulting graph is kept and
+   * used by \p PetscMatrix::init() for exact preallocation, until
+   * \p clear_csr_sparsity() is called.  Also enabled with the
+   * \p --csr-sparsity command line option.
+   */
+  void use_csr_sparsity (const bool use = true)
+  { _use_csr_sparsity = use; }
+
+  /**
+   * @returns the compressed sparse row graph of the local rows
+   * computed by the last \p compute_sparsity(), or \p NULL if it was
+   * not built or has been cleared.
+   */
+  const SparsityPattern::CSRGraph* get_csr_sparsity () const
+  { return _csr_sparsity.n_rows() ? &_csr_sparsity : NULL; }
+
+  /**
+   * Releases the memory used by the compressed sparse row graph,
+   * typically once every matrix has been initialized.
+   */
+  void clear_csr_sparsity ()
+  { _csr_sparsity.clear(); }
+
   /**
    * Attach an object to use to populate the
    * sparsity pattern with extra entries.
@@ -410,6 +584,39 @@ public:
 		    std::vector<unsigned int>& di,
 		    const unsigned int vn = libMesh::invalid_uint) const;
 
+  /**
+   * Keep the DOF indices of every active element in one contiguous
+   * array, built at the end of each \p distribute_dofs() and
+   * discarded by \p reinit().  \p dof_indices() then copies the
+   * cached indices, and \p dof_indices_block() returns them without
+   * copying.  Also enabled with the \p --cache-dof-indices command
+   * line option.  Code which modifies DOF numbers or p levels without
+   * calling \p distribute_dofs() must disable the cache.
+   */
+  void enable_dof_indices_cache (const bool enable = true);
+
+  /**
+   * @returns the active local elements of \p mesh split into colors
+   * which share no degrees of freedom, built on first use and kept
+   * until the degrees of freedom or constraints change.  See
+   * \p ColoredElemRange.
+   */
+  ColoredElemRange& colored_elem_range (const MeshBase& mesh);
+
+  /**
+   * @returns true if the DOF indices of \p elem are cached.
+   */
+  bool dof_indices_cached (const Elem* const elem) const;
+
+  /**
+   * @returns the cached global degree of freedom indices for the
+   * element, in the same order as \p dof_indices().  If no variable
+   * number is specified then all variables are returned.  The
+   * indices must be cached, see \p dof_indices_cached().
+   */
+  IndexBlock dof_indices_block (const Elem* const elem,
+				const unsigned int vn = libMesh::invalid_uint) const;
+
   /**
    * Fills the vector \p di with the global degree of freedom indices
    * corresponding to the SCALAR variable vn. If old_dofs=true,
@@ -482,6 +689,27 @@ public:
    */
   void create_dof_constraints (const MeshBase&, Real time=0);
 
+  /**
+   * Keep the hanging node constraints of each element between calls
+   * to \p create_dof_constraints(), and only recompute them on the
+   * elements whose neighborhood (the element, its parent and its side
+   * neighbors) has changed since the previous call; see
+   * \p DofConstraintCache.  This pays off in adaptive loops where
+   * most of the mesh is unchanged between refinement steps.  Periodic
+   * and Dirichlet constraints are always recomputed, and meshes with
+   * periodic boundaries or p refinement fall back to a full
+   * recomputation.  Also enabled with the \p --incremental-constraints
+   * command line option.  Code which moves nodes must disable and
+   * re-enable this to discard the cached constraints.
+   */
+  void enable_incremental_constraints (const bool enable = true);
+
+  /**
+   * @returns true if incremental constraints are enabled.
+   */
+  bool incremental_constraints () const
+    { return _constraint_cache.get() != NULL; }
+
   /**
    * Gathers any relevant constraint equations from other processors
    */
@@ -492,7 +720,17 @@ public:
    * to be constrained only in terms of unconstrained dofs, then adds
    * unconstrained dofs to the send_list and prepares that for use.
    * This should be run after both system (create_dof_constraints) and
-   * user constraints have all been added.
+   * user constraints have all been added.  It also records which
+   * active local elements of \p mesh have constrained degrees of
+   * freedom, for \p has_constrained_dofs().
+   */
+  void process_constraints (const MeshBase& mesh);
+
+  /**
+   * Deprecated form of \p process_constraints(const MeshBase&).  It
+   * does not record which elements have constrained degrees of
+   * freedom, so \p has_constrained_dofs() returns true for every
+   * element until the constraints are processed with a mesh.
    */
   void process_constraints ();
 
@@ -527,6 +765,14 @@ public:
   DofConstraints::const_iterator constraint_rows_end() const
     { return _dof_constraints.end(); }
 
+  /**
+   * Returns the packed constraint rows built by
+   * \p process_constraints().  They are not available (\p built()
+   * returns false) while constraints are still being added.
+   */
+  const PackedDofConstraints& packed_constraints() const
+    { return _packed_constraints; }
+
 #ifdef LIBMESH_ENABLE_NODE_CONSTRAINTS
   /**
    * Returns an iterator pointing to the first Node constraint row
@@ -579,6 +825,15 @@ public:
   // increase API compatibility of user code with different library
   // builds.
 
+  /**
+   * @returns false if none of the degrees of freedom of the active
+   * local element \p elem are constrained, in which case the
+   * \p constrain_element_*() methods leave its matrices and vectors
+   * unchanged and assembly code may skip them.  Returns true for
+   * elements that were not seen by the last \p process_constraints().
+   */
+  bool has_constrained_dofs (const Elem* elem) const;
+
   /**
    * Constrains the element matrix.  This method requires the
    * element matrix to be square, in which case the elem_dofs
@@ -883,12 +1138,52 @@ private:
   void distribute_local_dofs_node_major (unsigned int& next_free_dof,
 				         MeshBase& mesh);
 
+  /**
+   * Numbers the nodal and element degrees of freedom of variables
+   * \p var_begin through \p var_end-1 on the active local elements
+   * \p elems, on multiple threads.  Gives the same numbers as the
+   * serial element loops of \p distribute_local_dofs_var_major (one
+   * variable at a time) and \p distribute_local_dofs_node_major (all
+   * variables at once): the dofs of a node go to the first element
+   * which reaches it, and the first dof of each element comes from a
+   * prefix sum of the number of dofs each element numbers.  Only
+   * finding the first elements is serial.
+   */
+  void distribute_local_elem_dofs_threaded (unsigned int& next_free_dof,
+					    const std::vector<Elem*>& elems,
+					    const unsigned int var_begin,
+					    const unsigned int var_end);
+
   /**
    * Adds entries to the \p _send_list vector corresponding to DoFs
    * on elements neighboring the current processor.
    */
   void add_neighbors_to_send_list(MeshBase& mesh);
 
+  /**
+   * Renumbers the degrees of freedom on this processor, within the
+   * same range, in the order chosen by \p _dof_renumbering.
+   */
+  void renumber_local_dofs (MeshBase& mesh);
+
+  /**
+   * Fills the DOF indices cache for the active elements of \p mesh.
+   */
+  void build_dof_indices_cache (const MeshBase& mesh);
+
+  /**
+   * Discards the DOF indices cache.
+   */
+  void clear_dof_indices_cache ();
+
+  /**
+   * Sets \p block to the cached indices of variable \p vn (or all
+   * variables) on \p elem, returning false if there are none.
+   */
+  bool find_cached_dof_indices (const Elem* const elem,
+				const unsigned int vn,
+				IndexBlock& block) const;
+
 #ifdef LIBMESH_ENABLE_CONSTRAINTS
 
   /**
@@ -926,6 +1221,19 @@ private:
    */
   void find_connected_dofs (std::vector<unsigned int> &elem_dofs) const;
 
+  /**
+   * @returns the packed constraint rows, which the element constraint
+   * routines read.  It is an error to use them after constraints have
+   * been added without calling \p process_constraints() again.
+   */
+  const PackedDofConstraints& processed_constraints () const;
+
+  /**
+   * Expands the constraint rows to be in terms of unconstrained dofs
+   * only, and packs them.  Used by \p process_constraints().
+   */
+  void expand_constraints ();
+
   /**
    * Finds all the DofObjects associated with the set in \p objs.
    * This will account for off-element couplings via hanging nodes.
@@ -1012,6 +1320,40 @@ private:
    */
   void * _extra_send_list_context;
 
+  /**
+   * The renumbering of the local degrees of freedom, if any.
+   */
+  AutoPtr<DofRenumbering> _dof_renumbering;
+
+  /**
+   * Flag to cache the DOF indices of the active elements.
+   */
+  bool _cache_dof_indices;
+
+  /**
+   * The cached DOF indices of all active elements, each element's
+   * indices in \p dof_indices() order.
+   */
+  std::vector<unsigned int> _dof_indices_cache;
+
+  /**
+   * The element each cache entry belongs to, indexed by element id,
+   * or \p NULL for elements without cached indices.
+   */
+  std::vector<const Elem*> _dof_indices_cache_elem;
+
+  /**
+   * For each element id, the start and size in \p _dof_indices_cache
+   * of all the indices and then of the indices of each variable.
+   */
+  std::vector<unsigned int> _dof_indices_cache_blocks;
+
+  /**
+   * The coloring of the active local elements, if one has been
+   * requested since the degrees of freedom last changed.
+   */
+  ColoredElemRange _colored_elem_range;
+
   /**
    * The number of on-processor nonzeros in my portion of the
    * global matrix.
@@ -1024,6 +1366,18 @@ private:
    */
   std::vector<unsigned int> _n_oz;
 
+  /**
+   * Flag to compute the sparsity pattern with
+   * \p SparsityPattern::CSRBuild.
+   */
+  bool _use_csr_sparsity;
+
+  /**
+   * The compressed sparse row graph of my portion of the global
+   * matrix, when it has been computed.
+   */
+  SparsityPattern::CSRGraph _csr_sparsity;
+
   /**
    * Total number of degrees of freedom.
    */
@@ -1060,6 +1414,26 @@ private:
    * entry is the constraint matrix row for DOF i.
    */
   DofConstraints _dof_constraints;
+
+  /**
+   * The packed copy of \p _dof_constraints built by
+   * \p process_constraints(), which is discarded as soon as
+   * \p _dof_constraints changes again.
+   */
+  PackedDofConstraints _packed_constraints;
+
+  /**
+   * One flag per element id, set for the active local elements
+   * with constrained degrees of freedom.
+   */
+  std::vector<bool> _elem_has_constraints;
+
+  /**
+   * The hanging node constraints of each element from the previous
+   * \p create_dof_constraints(), if incremental constraints are
+   * enabled.
+   */
+  AutoPtr<DofConstraintCache> _constraint_cache;
 #endif
 
 #ifdef LIBMESH_ENABLE_NODE_CONSTRAINTS
@@ -1087,6 +1461,8 @@ private:
 #endif
 
   friend class SparsityPattern::Build;
+  friend class SparsityPattern::CSRBuild;
+  friend class ColoredElemRange;
 };
 
 
@@ -1119,6 +1495,9 @@ node
 inline
 bool DofMap::is_constrained_dof (const unsigned int dof) const
 {
+  if (_packed_constraints.built())
+    return _packed_constraints.is_constrained(dof);
+
   if (_dof_constraints.count(dof))
     return true;
 
@@ -1132,6 +1511,8 @@ bool DofMap::is_constrained_dof (const unsigned int dof) const
   // constraints are disabled, so there's no reason for users not to
   // use them.
 
+inline bool DofMap::has_constrained_dofs (const Elem*) const { return false; }
+
 inline void DofMap::constrain_element_matrix (DenseMatrix<Number>&,
 				              std::vector<unsigned int>&,
 				              bool) const {}
@@ -0,0 +1,127 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef __dof_renumbering_h__
+#define __dof_renumbering_h__
+
+// Local Includes -----------------------------------
+#include "libmesh_common.h"
+#include "auto_ptr.h"
+#include "point.h"
+
+// C++ Includes   -----------------------------------
+#include <string>
+#include <vector>
+
+namespace libMesh
+{
+
+// Forward Declarations
+class DofObject;
+
+
+/**
+ * The \p DofRenumbering class provides a uniform interface for
+ * algorithms which reorder the degrees of freedom local to a
+ * processor, to improve the cache reuse of sparse matrix-vector
+ * products and incomplete factorizations and to narrow the range of
+ * off-processor entries.  A renumbering attached with
+ * \p DofMap::dof_renumbering() is applied at the end of every
+ * \p DofMap::distribute_dofs().
+ *
+ * The degrees of freedom of one variable on one \p DofObject are
+ * numbered contiguously, so renumbering orders the local
+ * \p DofObject s; each object then receives all its degrees of
+ * freedom at once.  The numbering therefore is node-major, and
+ * \p DofMap::variable_first_local_dof() is not available.
+ */
+
+// ------------------------------------------------------------
+// DofRenumbering class definition
+class DofRenumbering
+{
+public:
+
+  /**
+   * The local \p DofObject s which own degrees of freedom and their
+   * connectivity.  Two objects are adjacent if they both belong to
+   * one active local element; the neighbors of object \p i are
+   * neighbors[offsets[i]], ..., neighbors[offsets[i+1]-1].
+   */
+  struct Graph
+  {
+    std::vector<DofObject*> objects;
+    std::vector<Point> points;
+    std::vector<unsigned int> offsets;
+    std::vector<unsigned int> neighbors;
+  };
+
+  /**
+   * Destructor. Virtual so that we can derive from this class.
+   */
+  virtual ~DofRenumbering() {}
+
+  /**
+   * Builds the renumbering named \p name, which is either \p "rcm" or
+   * \p "hilbert".
+   */
+  static AutoPtr<DofRenumbering> build (const std::string& name);
+
+  /**
+   * Fills \p order with a permutation of the objects of \p graph:
+   * \p order[k] is the index of the object to number k-th.
+   */
+  virtual void order (const Graph& graph,
+		      std::vector<unsigned int>& order) = 0;
+};
+
+
+
+/**
+ * Reverse Cuthill-McKee ordering of the local object graph, which
+ * reduces the bandwidth of the local block of the matrix.
+ */
+class RCMDofRenumbering : public DofRenumbering
+{
+public:
+
+  virtual void order (const Graph& graph,
+		      std::vector<unsigned int>& order);
+};
+
+
+
+/**
+ * Ordering of the local objects along a Hilbert space-filling curve
+ * through their locations.  It does not depend on the connectivity,
+ * and keeps geometrically close degrees of freedom close in memory.
+ * Requires libHilbert.
+ */
+class HilbertDofRenumbering : public DofRenumbering
+{
+public:
+
+  virtual void order (const Graph& graph,
+		      std::vector<unsigned int>& order);
+};
+
+
+} // namespace libMesh
+
+#endif // __dof_renumbering_h__
@@ -56,9 +56,18 @@ class PerfLog;
 #ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
 
 // Note the log is in libMesh, so we need to include it.
+//
+// Each call site looks up its event handle once and caches it, so
+// the event names passed to these macros must not change from one
+// call to the next; use libMesh::perflog.push()/pop() directly for
+// names computed at run time.
 #  include "libmesh.h"
-#  define START_LOG(a,b)   { libMesh::perflog.push(a,b); }
-#  define STOP_LOG(a,b)    { libMesh::perflog.pop(a,b); }
+#  define START_LOG(a,b)   { static const unsigned int libmesh_log_event_id = \
+                               libMesh::perflog.get_event_id(a,b);           \
+                             libMesh::perflog.push(libmesh_log_event_id); }
+#  define STOP_LOG(a,b)    { static const unsigned int libmesh_log_event_id = \
+                               libMesh::perflog.get_event_id(a,b);           \
+                             libMesh::perflog.pop(libmesh_log_event_id); }
 #  define PALIBMESH_USE_LOG(a,b)   { libmesh_deprecated(); }
 #  define RESTART_LOG(a,b) { libmesh_deprecated(); }
 
@@ -30,6 +30,12 @@
 #include <string>
 #include <map>
 
+// Thread-local storage lets every thread count its objects without
+// synchronization.
+#ifdef LIBMESH_TLS
+#  define LIBMESH_REFERENCE_COUNTER_THREAD_LOCAL
+#endif
+
 namespace libMesh
 {
 
@@ -39,6 +45,14 @@ namespace libMesh
  * This is the base class for enabling reference counting.  It
  * should not be used by the user, thus it has a private constructor.
  *
+ * Each thread keeps its own counts, which are only summed when they
+ * are queried, so that constructing and destroying objects from
+ * several threads does not serialize on a lock.  The sums are only
+ * exact when no other thread is creating or destroying objects.
+ * With the native pthread threading the counts of a thread which
+ * exits are folded into a common record, and its storage is reused
+ * by the next new thread.
+ *
  * \author Benjamin S. Kirk, 2002-2007
  */
 
@@ -76,8 +90,7 @@ public:
    * Prints the number of outstanding (created, but not yet
    * destroyed) objects.
    */
-  static unsigned int n_objects ()
-  { return _n_objects; }
+  static unsigned int n_objects ();
 
   /**
    * Methods to enable/disable the reference counter output
@@ -96,14 +109,14 @@ protected:
    * the constructor of any derived class that will be
    * reference counted.
    */
-  void increment_constructor_count (const std::string& name);
+  void increment_constructor_count (const char* name);
 
   /**
    * Increments the destruction counter. Should be called in
    * the destructor of any derived class that will be
    * reference counted.
    */
-  void increment_destructor_count (const std::string& name);
+  void increment_destructor_count (const char* name);
 
   /**
    * Data structure to log the information.  The log is
@@ -112,21 +125,85 @@ protected:
   typedef std::map<std::string, std::pair<unsigned int,
 					  unsigned int> > Counts;
 
+#endif
+
   /**
-   * Actually holds the data.
+   * The counts of one thread.  Objects may be destroyed by a
+   * different thread than the one which created them, so the number
+   * of objects of a single thread may be negative.
    */
-  static Counts _counts;
+  struct ThreadCounts
+  {
+    ThreadCounts () : n_objects(0), next(NULL), next_free(NULL) {}
+
+    int n_objects;
 
+#if defined(LIBMESH_ENABLE_REFERENCE_COUNTING) && defined(DEBUG)
+    /**
+     * Creations and destructions, keyed by the \p typeid name of the
+     * class, which is the same pointer for every object of a class.
+     */
+    std::map<const char*, std::pair<unsigned int,
+				    unsigned int> > counts;
 #endif
 
+    ThreadCounts* next;
+
+    /**
+     * The next counts on the free list, if these are on it.
+     */
+    ThreadCounts* next_free;
+  };
+
+  /**
+   * @returns the counts of the calling thread, registering them on
+   * the first call from a new thread.
+   */
+  static ThreadCounts& thread_counts ();
+
+  /**
+   * Takes counts for a new thread from the free list, or allocates
+   * them and adds them to the list.
+   */
+  static ThreadCounts* register_thread_counts ();
+
+  /**
+   * Called when a thread with counts \p tc exits.  Adds the counts
+   * to \p _finished_counts, since the objects of the thread may still
+   * be alive, then clears them and puts them on the free list.
+   */
+  static void release_thread_counts (void* tc);
+
+  /**
+   * The list of the counts of every thread which is creating or
+   * destroying objects, of \p _finished_counts and of the free list.
+   */
+  static ThreadCounts* _thread_counts_head;
+
   /**
-   * The number of objects.  Print the reference count
-   * information when the number returns to 0.
+   * The summed counts of every thread which has exited, or \p NULL
+   * if there are none yet.
    */
-  static Threads::atomic<unsigned int> _n_objects;
+  static ThreadCounts* _finished_counts;
+
+  /**
+   * Counts which were released by exited threads, linked through
+   * \p ThreadCounts::next_free.
+   */
+  static ThreadCounts* _free_thread_counts;
+
+#ifdef LIBMESH_REFERENCE_COUNTER_THREAD_LOCAL
+  /**
+   * The counts of the calling thread.
+   */
+  static LIBMESH_TLS ThreadCounts* _local_counts;
+#endif
 
   /**
    * Mutual exclusion object to enable thread-safe reference counting.
+   * It only protects the list of thread counts, the finished counts
+   * and the free list, or every update when thread-local storage is
+   * not available.
    */
   static Threads::spin_mutex _mutex;
 
@@ -141,16 +218,41 @@ protected:
 
 // ------------------------------------------------------------
 // ReferenceCounter class inline methods
+inline
+ReferenceCounter::ThreadCounts& ReferenceCounter::thread_counts ()
+{
+#ifdef LIBMESH_REFERENCE_COUNTER_THREAD_LOCAL
+  if (_local_counts == NULL)
+    _local_counts = register_thread_counts();
+
+  return *_local_counts;
+#else
+  // All threads share one set of counts, guarded by _mutex.
+  if (_thread_counts_head == NULL)
+    register_thread_counts();
+
+  return *_thread_counts_head;
+#endif
+}
+
+
+
 inline ReferenceCounter::ReferenceCounter()
 {
-  _n_objects++;
+#ifndef LIBMESH_REFERENCE_COUNTER_THREAD_LOCAL
+  Threads::spin_mutex::scoped_lock lock(_mutex);
+#endif
+  thread_counts().n_objects++;
 }
 
 
 
 inline ReferenceCounter::~ReferenceCounter()
 {
-  _n_objects--;
+#ifndef LIBMESH_REFERENCE_COUNTER_THREAD_LOCAL
+  Threads::spin_mutex::scoped_lock lock(_mutex);
+#endif
+  thread_counts().n_objects--;
 }
 
 
@@ -160,10 +262,12 @@ inline ReferenceCounter::~ReferenceCounter()
 
 #if defined(LIBMESH_ENABLE_REFERENCE_COUNTING) && defined(DEBUG)
 inline
-void ReferenceCounter::increment_constructor_count (const std::string& name)
+void ReferenceCounter::increment_constructor_count (const char* name)
 {
-  Threads::spin_mutex::scoped_lock lock(Threads::spin_mtx);
-  std::pair<unsigned int, unsigned int>& p = _counts[name];
+#ifndef LIBMESH_REFERENCE_COUNTER_THREAD_LOCAL
+  Threads::spin_mutex::scoped_lock lock(_mutex);
+#endif
+  std::pair<unsigned int, unsigned int>& p = thread_counts().counts[name];
 
   p.first++;
 }
@@ -173,10 +277,12 @@ void ReferenceCounter::increment_constructor_count (const std::string& name)
 
 #if defined(LIBMESH_ENABLE_REFERENCE_COUNTING) && defined(DEBUG)
 inline
-void ReferenceCounter::increment_destructor_count (const std::string& name)
+void ReferenceCounter::increment_destructor_count (const char* name)
 {
-  Threads::spin_mutex::scoped_lock lock(Threads::spin_mtx);
-  std::pair<unsigned int, unsigned int>& p = _counts[name];
+#ifndef LIBMESH_REFERENCE_COUNTER_THREAD_LOCAL
+  Threads::spin_mutex::scoped_lock lock(_mutex);
+#endif
+  std::pair<unsigned int, unsigned int>& p = thread_counts().counts[name];
 
   p.second++;
 }
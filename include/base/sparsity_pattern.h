@@ -119,6 +119,99 @@ namespace SparsityPattern // use a namespace so member classes can be forward-de
     void join (const Build &other);
   };
 
+  /**
+   * The sparsity pattern of the local rows of a matrix in compressed
+   * sparse row form.  The sorted global column indices of the nonzero
+   * entries of local row i are
+   * cols[offsets[i]], ..., cols[offsets[i+1]-1].  This layout can be
+   * handed to \p PetscMatrix preallocation directly.
+   */
+  class CSRGraph
+  {
+  public:
+    std::vector<unsigned int> offsets;
+    std::vector<unsigned int> cols;
+
+    /**
+     * @returns the number of rows in the graph.
+     */
+    unsigned int n_rows () const
+    { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    /**
+     * @returns the number of nonzeros in local row \p i.
+     */
+    unsigned int row_size (const unsigned int i) const
+    { return offsets[i+1] - offsets[i]; }
+
+    /**
+     * Releases the memory used by the graph.
+     */
+    void clear ();
+
+    /**
+     * Swaps the contents of two graphs.
+     */
+    void swap (CSRGraph &other);
+
+    /**
+     * Copies the graph into the row-by-row \p Graph format, for
+     * matrix formats and user callbacks which expect it.
+     */
+    void to_graph (Graph &graph) const;
+  };
+
+  /**
+   * This helper class computes the same pattern as \p Build, but
+   * directly in \p CSRGraph form.  A counting pass over the elements
+   * sizes every row (duplicates included), a fill pass writes the
+   * column indices into one contiguous array, and each row is then
+   * sorted and made unique in place.  This avoids the per-row
+   * allocations and repeated merges of \p Build, at the price of
+   * temporarily storing duplicate entries.  The final per-row sort is
+   * done on multiple threads.  The counts including duplicates are
+   * kept in \p std::size_t; only the final graph, which must have
+   * fewer nonzeros than the largest \p unsigned \p int, is indexed
+   * by \p unsigned \p int.
+   */
+  class CSRBuild
+  {
+  private:
+    const MeshBase &mesh;
+    const DofMap &dof_map;
+    const CouplingMatrix *dof_coupling;
+    const bool implicit_neighbor_dofs;
+
+    /**
+     * Calls \p f(local_row, cols) for every local row each element in
+     * \p range contributes to, with the (unsorted) global columns
+     * \p cols it couples to.
+     */
+    template <typename RowFunctor>
+    void visit_rows (const ConstElemRange &range, RowFunctor &f) const;
+
+  public:
+
+    SparsityPattern::CSRGraph graph;
+    std::vector<unsigned int> n_nz;
+    std::vector<unsigned int> n_oz;
+
+    CSRBuild (const MeshBase &mesh_in,
+	      const DofMap &dof_map_in,
+	      const CouplingMatrix *dof_coupling_in,
+	      const bool implicit_neighbor_dofs_in) :
+      mesh(mesh_in),
+      dof_map(dof_map_in),
+      dof_coupling(dof_coupling_in),
+      implicit_neighbor_dofs(implicit_neighbor_dofs_in),
+      graph(),
+      n_nz(),
+      n_oz()
+    {}
+
+    void operator()(const ConstElemRange &range);
+  };
+
 #if defined(__GNUC__) && (__GNUC__ < 4) && !defined(__INTEL_COMPILER)
   /**
    * Dummy function that does nothing but can be used to prohibit
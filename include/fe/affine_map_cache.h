@@ -0,0 +1,139 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef __affine_map_cache_h__
+#define __affine_map_cache_h__
+
+// Local includes
+#include "libmesh_common.h"
+#include "vector_value.h"
+
+// C++ includes
+#include <cstddef>
+#include <vector>
+
+namespace libMesh
+{
+
+// forward declarations
+class Elem;
+class MeshBase;
+
+
+
+/**
+ * This class stores the constant geometric factors (the tangents
+ * dx/dxi, the inverse Jacobian and the Jacobian determinant) of every
+ * element of a mesh whose map is affine, i.e. every element for which
+ * \p Elem::has_affine_map() is true: \p TRI3, \p TET4, parallelogram
+ * \p QUAD4, parallelepiped \p HEX8, and so on.  \p FEMap::compute_affine_map()
+ * copies these factors instead of recomputing them when a cache has
+ * been attached with \p FEAbstract::attach_affine_map_cache().
+ *
+ * The cache is normally obtained from \p MeshBase::affine_map_cache(),
+ * which builds it on first use and rebuilds it at every subsequent
+ * \p MeshBase::prepare_for_use(), and therefore after every
+ * refinement step.  Nothing detects nodes being moved, so code
+ * which moves nodes without calling \p prepare_for_use() gets stale
+ * factors unless it rebuilds the cache itself, e.g. with
+ * \p MeshBase::clear_affine_map_cache() followed by
+ * \p MeshBase::affine_map_cache().
+ *
+ * Lookups only read the stored data, so a built cache may be shared
+ * by the \p FE objects of several threads.
+ */
+
+// ------------------------------------------------------------
+// AffineMapCache class definition
+class AffineMapCache
+{
+public:
+
+  /**
+   * The geometric factors of one element.  Entries which do not
+   * apply to the dimension of the element are left at zero.
+   */
+  struct Factors
+  {
+    RealGradient dxyzdxi, dxyzdeta, dxyzdzeta;
+
+    Real dxidx,   dxidy,   dxidz;
+    Real detadx,  detady,  detadz;
+    Real dzetadx, dzetady, dzetadz;
+
+    Real jac;
+  };
+
+  /**
+   * Constructor.  Creates an empty cache.
+   */
+  AffineMapCache ();
+
+  /**
+   * Discards any existing data and computes the factors of every
+   * element of \p mesh which has an affine map.
+   */
+  void build (const MeshBase& mesh);
+
+  /**
+   * Deletes all the data that are currently stored.
+   */
+  void clear ();
+
+  /**
+   * @returns true if \p build() has been called since the last
+   * \p clear().
+   */
+  bool built () const { return _built; }
+
+  /**
+   * @returns the factors stored for \p elem, or \p NULL if there are
+   * none.  An entry is only returned for the very element object it
+   * was computed for, so stale entries are never used for a new
+   * element which happens to reuse an id.
+   */
+  const Factors* find (const Elem* elem) const;
+
+  /**
+   * @returns the number of elements with stored factors.
+   */
+  unsigned int n_entries () const { return _n_entries; }
+
+  /**
+   * @returns the number of bytes used by the stored arrays.
+   */
+  std::size_t memory_usage () const;
+
+private:
+
+  /**
+   * The factors and the element they belong to, indexed by element
+   * id.  Ids without stored factors map to a \p NULL element.
+   */
+  std::vector<Factors>     _factors;
+  std::vector<const Elem*> _elems;
+
+  unsigned int _n_entries;
+  bool _built;
+};
+
+
+} // namespace libMesh
+
+#endif // #ifndef __affine_map_cache_h__
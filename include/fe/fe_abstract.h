@@ -44,6 +44,7 @@ namespace libMesh
 // forward declarations
 template <typename T> class DenseMatrix;
 template <typename T> class DenseVector;
+class AffineMapCache;
 class BoundaryInfo;
 class DofConstraints;
 class DofMap;
@@ -443,6 +444,15 @@ public:
    */
   const FEMap& get_fe_map() const { return *_fe_map.get(); }
 
+  /**
+   * Makes subsequent \p reinit() calls on elements with an affine
+   * map copy their geometric factors from \p cache, typically
+   * \p MeshBase::affine_map_cache(), instead of computing them.
+   * Pass \p NULL to go back to computing the map every time.
+   */
+  void attach_affine_map_cache (const AffineMapCache* cache)
+  { _fe_map->set_affine_map_cache(cache); }
+
   /**
    * Prints the Jacobian times the weight for each quadrature point.
    */
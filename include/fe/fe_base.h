@@ -29,6 +29,7 @@
 #include "fe_type.h"
 #include "auto_ptr.h"
 #include "fe_transformation_base.h"
+#include "fe_shape_block.h"
 
 // C++ includes
 #include <cstddef>
@@ -298,6 +299,42 @@ public:
   { libmesh_assert(!calculations_started || calculate_dphiref);
     calculate_dphiref = true; return dphidzeta; }
 
+  /**
+   * @returns the shape function values at the quadrature points,
+   * packed into a single contiguous dof-by-qp block.  The block is
+   * computed directly by each \p reinit(); if \p get_phi() was
+   * requested too, its values are copied from the block.
+   */
+  const FEShapeBlock<OutputShape>& get_packed_phi() const
+  { libmesh_assert(!calculations_started || calculate_packed_phi);
+    calculate_packed_phi = true; return packed_phi; }
+
+  /**
+   * @returns the shape function x-derivatives at the quadrature
+   * points, packed into a single contiguous dof-by-qp block.  If
+   * \p get_dphi() or \p get_dphidx() and friends were requested too,
+   * their values are copied from the blocks.
+   */
+  const FEShapeBlock<OutputShape>& get_packed_dphidx() const
+  { libmesh_assert(!calculations_started || calculate_packed_dphi);
+    calculate_packed_dphi = calculate_dphiref = true; return packed_dphidx; }
+
+  /**
+   * @returns the shape function y-derivatives at the quadrature
+   * points, packed into a single contiguous dof-by-qp block.
+   */
+  const FEShapeBlock<OutputShape>& get_packed_dphidy() const
+  { libmesh_assert(!calculations_started || calculate_packed_dphi);
+    calculate_packed_dphi = calculate_dphiref = true; return packed_dphidy; }
+
+  /**
+   * @returns the shape function z-derivatives at the quadrature
+   * points, packed into a single contiguous dof-by-qp block.
+   */
+  const FEShapeBlock<OutputShape>& get_packed_dphidz() const
+  { libmesh_assert(!calculations_started || calculate_packed_dphi);
+    calculate_packed_dphi = calculate_dphiref = true; return packed_dphidz; }
+
 #ifdef LIBMESH_ENABLE_SECOND_DERIVATIVES
 
   /**
@@ -498,6 +535,14 @@ protected:
    */
   virtual void compute_shape_functions(const Elem* elem, const std::vector<Point>& qp);
 
+  /**
+   * Packs \p phi and \p dphidx, \p dphidy and \p dphidz into the
+   * packed blocks requested.  For the derived classes which only
+   * compute the vector-of-vectors data, and which must then compute
+   * that data whenever a block is requested.
+   */
+  void pack_shape_functions();
+
   /**
    * Object that handles computing shape function values, gradients, etc
    * in the physical domain.
@@ -554,6 +599,23 @@ protected:
    */
   std::vector<std::vector<OutputShape> >   dphidz;
 
+  /**
+   * Should we calculate the packed shape function values and
+   * derivatives below?
+   */
+  mutable bool calculate_packed_phi;
+  mutable bool calculate_packed_dphi;
+
+  /**
+   * Shape function values and derivatives in packed blocks.  Where
+   * these are calculated, \p phi, \p dphidx, \p dphidy and \p dphidz
+   * are only filled as copies of them, on request.
+   */
+  FEShapeBlock<OutputShape> packed_phi;
+  FEShapeBlock<OutputShape> packed_dphidx;
+  FEShapeBlock<OutputShape> packed_dphidy;
+  FEShapeBlock<OutputShape> packed_dphidz;
+
 
 #ifdef LIBMESH_ENABLE_SECOND_DERIVATIVES
 
@@ -698,7 +760,13 @@ FEGenericBase<OutputType>::FEGenericBase(const unsigned int d,
   dphidzeta(),
   dphidx(),
   dphidy(),
-  dphidz()
+  dphidz(),
+  calculate_packed_phi(false),
+  calculate_packed_dphi(false),
+  packed_phi(),
+  packed_dphidx(),
+  packed_dphidy(),
+  packed_dphidz()
 #ifdef LIBMESH_ENABLE_SECOND_DERIVATIVES
   ,d2phi(),
   d2phidxi2(),
@@ -32,6 +32,7 @@ namespace libMesh
   
 // forward declarations
 class Elem;
+class AffineMapCache;
 
   class FEMap
   {
@@ -309,6 +310,14 @@ class Elem;
      */
     void print_xyz(std::ostream& os) const;
 
+    /**
+     * Provides a cache of precomputed geometric factors which
+     * \p compute_affine_map() uses instead of recomputing the map of
+     * elements found in it.  Pass \p NULL to stop using a cache.
+     */
+    void set_affine_map_cache(const AffineMapCache* cache)
+    { _affine_map_cache = cache; }
+
     /* FIXME: PB: The public functions below break encapsulation! I'm not happy
        about it, but I don't have time to redo the infinite element routines.
        These are needed in inf_fe_boundary.C and inf_fe.C. A proper implementation
@@ -728,6 +737,11 @@ class Elem;
      */
     std::vector<Real>                 JxW;
 
+    /**
+     * Precomputed factors for affine elements, or \p NULL.
+     */
+    const AffineMapCache*             _affine_map_cache;
+
 
   private:
     
@@ -780,7 +794,8 @@ class Elem;
      normals(),
      curvatures(),
      jac(),
-     JxW()
+     JxW(),
+     _affine_map_cache(NULL)
   {}
   
 }
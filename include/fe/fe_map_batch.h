@@ -0,0 +1,228 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef __fe_map_batch_h__
+#define __fe_map_batch_h__
+
+// Local includes
+#include "libmesh_common.h"
+#include "auto_ptr.h"
+#include "enum_elem_type.h"
+#include "fe_type.h"
+
+// C++ includes
+#include <vector>
+
+namespace libMesh
+{
+
+// forward declarations
+class Elem;
+class QBase;
+template <typename OutputType> class FEGenericBase;
+typedef FEGenericBase<Real> FEBase;
+
+
+
+/**
+ * This class computes the reference-to-physical map for a batch of
+ * up to \p n_lanes elements of the same type at once.  Where
+ * \p FEBase::reinit() evaluates the mapping shape functions, the
+ * Jacobian and its inverse one element at a time, \p FEMapBatch
+ * evaluates the reference data once per element type and quadrature
+ * rule and then runs every geometric loop across all the elements of
+ * the batch.  The results are stored lane-interleaved: the value for
+ * element \p l of the batch at quadrature point \p qp is entry
+ * \p qp*n_lanes+l, so the innermost loop always runs over a fixed
+ * number of independent elements and vectorizes without gathers.
+ *
+ * For a batch of \p n elements, with \p n smaller than \p n_lanes,
+ * the unused lanes repeat the last element; their values are valid
+ * but should be ignored.
+ *
+ * Only the map itself and the physical gradients of the
+ * approximation shape functions are computed.  The class is
+ * restricted to elements whose dimension matches \p dim and which
+ * lie in the first \p dim coordinate directions (e.g. 2D elements in
+ * the xy-plane), and to finite element families whose shape
+ * functions are defined on the master element independently of the
+ * physical element (\p LAGRANGE, \p L2_LAGRANGE and \p MONOMIAL).
+ * Typical use in an assembly loop looks like
+ *
+ * \verbatim
+ *   FEMapBatch batch (dim, fe_type);
+ *   batch.attach_quadrature_rule (&qrule);
+ *
+ *   const std::vector<Real>& JxW = batch.get_JxW();
+ *   const std::vector<Real>& dphidx = batch.get_dphidx();
+ *
+ *   // elems holds up to FEMapBatch::n_lanes elements of one type
+ *   batch.reinit (elems);
+ *
+ *   for (unsigned int qp=0; qp<batch.n_qp(); qp++)
+ *     for (unsigned int l=0; l<FEMapBatch::n_lanes; l++)
+ *       ... JxW[qp*FEMapBatch::n_lanes + l] ...
+ * \endverbatim
+ */
+
+// ------------------------------------------------------------
+// FEMapBatch class definition
+class FEMapBatch
+{
+public:
+
+  /**
+   * The number of elements processed together.
+   */
+  static const unsigned int n_lanes = 8;
+
+  /**
+   * Constructor.  \p dim is the dimension of the elements that will
+   * be passed to \p reinit().
+   */
+  FEMapBatch (const unsigned int dim,
+	      const FEType& fe_type);
+
+  /**
+   * Destructor.
+   */
+  ~FEMapBatch ();
+
+  /**
+   * Provides the quadrature rule used by subsequent calls to
+   * \p reinit().
+   */
+  void attach_quadrature_rule (QBase* q);
+
+  /**
+   * Computes the map and the physical shape function gradients for
+   * the elements in \p elems, which must all have the same type and
+   * p refinement level.  At most \p n_lanes elements may be passed.
+   */
+  void reinit (const std::vector<const Elem*>& elems);
+
+  /**
+   * @returns the number of elements in the current batch.
+   */
+  unsigned int n_elem () const { return _n_elem; }
+
+  /**
+   * @returns the number of quadrature points.
+   */
+  unsigned int n_qp () const { return _n_qp; }
+
+  /**
+   * @returns the number of approximation shape functions.
+   */
+  unsigned int n_shape_functions () const { return _n_shape; }
+
+  /**
+   * @returns the Jacobian determinants, indexed [qp*n_lanes + lane].
+   */
+  const std::vector<Real>& get_jacobian () const { return _jac; }
+
+  /**
+   * @returns the Jacobian determinants times the quadrature weights,
+   * indexed [qp*n_lanes + lane].
+   */
+  const std::vector<Real>& get_JxW () const { return _JxW; }
+
+  /**
+   * @returns the entries of the inverse Jacobian
+   * d(xi_r)/d(x_c), indexed [qp*n_lanes + lane].
+   */
+  const std::vector<Real>& get_inverse_jacobian (const unsigned int r,
+						 const unsigned int c) const
+  { libmesh_assert (r < _dim); libmesh_assert (c < _dim); return _inv_jac[r*3 + c]; }
+
+  /**
+   * @returns the physical shape function gradients, indexed
+   * [(i*n_qp + qp)*n_lanes + lane] for shape function \p i.
+   */
+  const std::vector<Real>& get_dphidx () const { return _dphi[0]; }
+  const std::vector<Real>& get_dphidy () const { return _dphi[1]; }
+  const std::vector<Real>& get_dphidz () const { return _dphi[2]; }
+
+private:
+
+  /**
+   * Evaluates the reference mapping and approximation shape function
+   * derivatives for elements like \p elem.
+   */
+  void init_reference_data (const Elem* elem);
+
+  /**
+   * The element dimension and approximation type.
+   */
+  const unsigned int _dim;
+  const FEType _fe_type;
+
+  /**
+   * The quadrature rule.
+   */
+  QBase* _qrule;
+
+  /**
+   * An \p FE object used to evaluate the reference derivatives of the
+   * approximation shape functions.
+   */
+  AutoPtr<FEBase> _fe;
+
+  /**
+   * The element type, p level and quadrature rule the reference data
+   * were computed for.
+   */
+  ElemType _elem_type;
+  unsigned int _p_level;
+  QBase* _ref_qrule;
+
+  /**
+   * Sizes of the current batch.
+   */
+  unsigned int _n_elem, _n_qp, _n_map, _n_shape;
+
+  /**
+   * Reference derivatives of the mapping and approximation shape
+   * functions, indexed [r][i*n_qp + qp].
+   */
+  std::vector<Real> _dmap_ref[3];
+  std::vector<Real> _dphi_ref[3];
+
+  /**
+   * Node coordinates of the batch, indexed [(i*3 + c)*n_lanes + lane].
+   */
+  std::vector<Real> _node_xyz;
+
+  /**
+   * The Jacobian dx_c/dxi_r, indexed [r*3 + c][qp*n_lanes + lane].
+   */
+  std::vector<Real> _J[9];
+
+  /**
+   * Outputs.
+   */
+  std::vector<Real> _jac, _JxW;
+  std::vector<Real> _inv_jac[9];
+  std::vector<Real> _dphi[3];
+};
+
+
+} // namespace libMesh
+
+#endif // #ifndef __fe_map_batch_h__
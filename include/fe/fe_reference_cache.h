@@ -0,0 +1,178 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef __fe_reference_cache_h__
+#define __fe_reference_cache_h__
+
+// Local includes
+#include "libmesh_common.h"
+#include "enum_elem_type.h"
+#include "fe_type.h"
+#include "point.h"
+#include "threads.h"
+
+// C++ includes
+#include <map>
+#include <vector>
+
+namespace libMesh
+{
+
+
+
+/**
+ * This class is a process-wide cache of reference-element shape
+ * function derivatives.  For finite element families whose shape
+ * functions do not depend on the physical element
+ * (i.e. \p FE::shapes_need_reinit() returns \p false) the
+ * derivatives with respect to the master element coordinates
+ * depend only on the \p FEType, the \p ElemType, the p refinement
+ * level and the evaluation points.  \p FE::init_shape_functions()
+ * stores them here once and copies them back on later calls,
+ * which avoids re-evaluating every shape function when an \p FE
+ * object alternates between element types, or between interior
+ * and side quadrature rules.
+ *
+ * The evaluation points themselves are part of the key, so side
+ * quadrature points mapped onto the different sides of an element
+ * get separate entries.  The number of entries is bounded by
+ * \p max_entries(); once the cache is full, further lookups which
+ * miss simply compute the data without storing it.
+ *
+ * Lookups and insertions are protected by a mutex, and entries are
+ * never modified after insertion, so the cache is safe to use from
+ * within \p Threads::parallel_for bodies.  \p clear() must not be
+ * called while other threads are using the cache.
+ */
+
+// ------------------------------------------------------------
+// FEReferenceCache class definition
+template <typename OutputShape>
+class FEReferenceCache
+{
+public:
+
+  /**
+   * The data identifying a set of reference shape function values.
+   */
+  struct Key
+  {
+    unsigned int       dim;
+    FEType             fe_type;
+    ElemType           elem_type;
+    unsigned int       p_level;
+    bool               second_derivatives;
+    std::vector<Point> points;
+
+    bool operator< (const Key& other) const;
+  };
+
+  /**
+   * The cached reference derivatives, indexed [shape function][point].
+   */
+  struct Entry
+  {
+    std::vector<std::vector<OutputShape> > dphidxi;
+    std::vector<std::vector<OutputShape> > dphideta;
+    std::vector<std::vector<OutputShape> > dphidzeta;
+
+#ifdef LIBMESH_ENABLE_SECOND_DERIVATIVES
+    std::vector<std::vector<OutputShape> > d2phidxi2;
+    std::vector<std::vector<OutputShape> > d2phidxideta;
+    std::vector<std::vector<OutputShape> > d2phideta2;
+    std::vector<std::vector<OutputShape> > d2phidxidzeta;
+    std::vector<std::vector<OutputShape> > d2phidetadzeta;
+    std::vector<std::vector<OutputShape> > d2phidzeta2;
+#endif
+  };
+
+  /**
+   * @returns the cached entry for \p key, or \p NULL if there is
+   * none.  Updates the hit/miss counters.
+   */
+  static const Entry* find (const Key& key);
+
+  /**
+   * Stores a copy of \p entry under \p key, unless the cache is full
+   * or another thread has already stored an entry for \p key.
+   */
+  static void insert (const Key& key,
+		      const Entry& entry);
+
+  /**
+   * Removes all entries and resets the counters.
+   */
+  static void clear ();
+
+  /**
+   * Enables or disables the cache.  The cache is enabled by default
+   * unless \p --disable-fe-reference-cache is given on the command
+   * line.
+   */
+  static void enable ()  { _enabled = true; }
+  static void disable () { _enabled = false; }
+  static bool enabled () { return _enabled; }
+
+  /**
+   * Sets/gets the maximum number of entries stored.
+   */
+  static void set_max_entries (const unsigned int n) { _max_entries = n; }
+  static unsigned int max_entries () { return _max_entries; }
+
+  /**
+   * @returns the number of entries currently stored.
+   */
+  static unsigned int n_entries ();
+
+  /**
+   * @returns the number of successful and failed lookups since the
+   * last \p clear().
+   */
+  static unsigned int n_hits ()   { return _n_hits; }
+  static unsigned int n_misses () { return _n_misses; }
+
+private:
+
+  /**
+   * The stored entries.
+   */
+  static std::map<Key, Entry> _cache;
+
+  /**
+   * Mutex protecting \p _cache.
+   */
+  static Threads::spin_mutex _mutex;
+
+  /**
+   * Lookup counters.  These are only updated while \p _mutex is held.
+   */
+  static unsigned int _n_hits;
+  static unsigned int _n_misses;
+
+  /**
+   * Settings.
+   */
+  static bool _enabled;
+  static unsigned int _max_entries;
+};
+
+
+} // namespace libMesh
+
+#endif // #ifndef __fe_reference_cache_h__
@@ -0,0 +1,257 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef __fe_shape_block_h__
+#define __fe_shape_block_h__
+
+// Local includes
+#include "libmesh_common.h"
+
+// C++ includes
+#include <cstddef>
+#include <vector>
+
+namespace libMesh
+{
+
+
+
+/**
+ * This class stores a shape function quantity (values or a single
+ * derivative component) for all degrees of freedom and quadrature
+ * points in one contiguous, dof-major block.  Row \p i holds the
+ * values of shape function \p i at every quadrature point, and
+ * consecutive rows are \p stride() entries apart.  The stride is
+ * padded to a multiple of \p alignment entries and the first row
+ * starts on an \p alignment boundary whenever the size of \p T
+ * permits, so that loops over quadrature points on a single row
+ * vectorize cleanly:
+ *
+ * \verbatim
+ *   for (unsigned int i=0; i<phi.n_dofs(); i++)
+ *     {
+ *       const Real* phi_i = phi.row(i);
+ *       for (unsigned int j=0; j<phi.n_dofs(); j++)
+ *         {
+ *           const Real* phi_j = phi.row(j);
+ *           for (unsigned int qp=0; qp<phi.n_qp(); qp++)
+ *             Ke(i,j) += JxW[qp]*phi_i[qp]*phi_j[qp];
+ *         }
+ *     }
+ * \endverbatim
+ */
+
+// ------------------------------------------------------------
+// FEShapeBlock class definition
+template <typename T>
+class FEShapeBlock
+{
+public:
+
+  /**
+   * The row alignment, in bytes.
+   */
+  static const unsigned int alignment = 64;
+
+  /**
+   * Constructor.  Creates an empty block.
+   */
+  FEShapeBlock () :
+    _n_dofs(0), _n_qp(0), _stride(0), _offset(0) {}
+
+  /**
+   * Resizes the block to hold \p n_dofs rows of \p n_qp entries.
+   * Existing values are not preserved.
+   */
+  void resize (const unsigned int n_dofs,
+	       const unsigned int n_qp);
+
+  /**
+   * Copies the values from a \p std::vector<std::vector<T> > laid out
+   * as returned by \p FEGenericBase::get_phi() and friends, resizing
+   * if necessary.
+   */
+  void pack (const std::vector<std::vector<T> >& values);
+
+  /**
+   * Copies the values into a \p std::vector<std::vector<T> > laid
+   * out as returned by \p FEGenericBase::get_phi() and friends,
+   * resizing it if necessary.
+   */
+  void unpack (std::vector<std::vector<T> >& values) const;
+
+  /**
+   * @returns the value of shape function \p i at quadrature point \p qp.
+   */
+  const T& operator() (const unsigned int i,
+		       const unsigned int qp) const
+  {
+    libmesh_assert (i < _n_dofs);
+    libmesh_assert (qp < _n_qp);
+    return _storage[_offset + i*_stride + qp];
+  }
+
+  /**
+   * @returns a writeable reference to the value of shape function
+   * \p i at quadrature point \p qp.
+   */
+  T& operator() (const unsigned int i,
+		 const unsigned int qp)
+  {
+    libmesh_assert (i < _n_dofs);
+    libmesh_assert (qp < _n_qp);
+    return _storage[_offset + i*_stride + qp];
+  }
+
+  /**
+   * @returns a pointer to the \p n_qp() values of shape function \p i.
+   */
+  const T* row (const unsigned int i) const
+  {
+    libmesh_assert (i < _n_dofs);
+    return &_storage[_offset + i*_stride];
+  }
+
+  /**
+   * @returns a writeable pointer to the \p n_qp() values of shape
+   * function \p i.
+   */
+  T* row (const unsigned int i)
+  {
+    libmesh_assert (i < _n_dofs);
+    return &_storage[_offset + i*_stride];
+  }
+
+  /**
+   * @returns the number of shape functions (rows).
+   */
+  unsigned int n_dofs () const { return _n_dofs; }
+
+  /**
+   * @returns the number of quadrature points (used entries per row).
+   */
+  unsigned int n_qp () const { return _n_qp; }
+
+  /**
+   * @returns the distance, in entries, between consecutive rows.
+   */
+  unsigned int stride () const { return _stride; }
+
+private:
+
+  /**
+   * The dimensions of the block.
+   */
+  unsigned int _n_dofs, _n_qp, _stride;
+
+  /**
+   * Index of the first entry of row 0 in \p _storage; nonzero
+   * when the start of the underlying allocation had to be skipped
+   * to reach an aligned address.
+   */
+  std::size_t _offset;
+
+  /**
+   * The underlying storage.
+   */
+  std::vector<T> _storage;
+};
+
+
+
+// ------------------------------------------------------------
+// FEShapeBlock member functions
+template <typename T>
+inline
+void FEShapeBlock<T>::resize (const unsigned int n_dofs,
+			      const unsigned int n_qp)
+{
+  // Only pad when whole entries fit evenly into an aligned chunk;
+  // otherwise the rows cannot all be aligned anyway.
+  const unsigned int per_chunk =
+    (alignment % sizeof(T) == 0) ? alignment / sizeof(T) : 1;
+
+  _n_dofs = n_dofs;
+  _n_qp   = n_qp;
+  _stride = ((n_qp + per_chunk - 1) / per_chunk) * per_chunk;
+
+  const std::size_t needed = static_cast<std::size_t>(_n_dofs)*_stride + per_chunk;
+
+  if (_storage.size() < needed)
+    _storage.resize(needed);
+
+  _offset = 0;
+
+  if (per_chunk > 1 && !_storage.empty())
+    {
+      const std::size_t addr = reinterpret_cast<std::size_t>(&_storage[0]);
+      const std::size_t misalignment = addr % alignment;
+
+      if (misalignment)
+        _offset = (alignment - misalignment) / sizeof(T);
+    }
+}
+
+
+
+template <typename T>
+inline
+void FEShapeBlock<T>::pack (const std::vector<std::vector<T> >& values)
+{
+  const unsigned int n_dofs = values.size();
+  const unsigned int n_qp   = n_dofs ? values[0].size() : 0;
+
+  if (n_dofs != _n_dofs || n_qp != _n_qp)
+    this->resize(n_dofs, n_qp);
+
+  for (unsigned int i=0; i != n_dofs; ++i)
+    {
+      libmesh_assert (values[i].size() == n_qp);
+
+      T* out = &_storage[_offset + i*_stride];
+      const T* in = n_qp ? &values[i][0] : NULL;
+
+      for (unsigned int qp=0; qp != n_qp; ++qp)
+        out[qp] = in[qp];
+    }
+}
+
+
+template <typename T>
+inline
+void FEShapeBlock<T>::unpack (std::vector<std::vector<T> >& values) const
+{
+  values.resize (_n_dofs);
+
+  for (unsigned int i=0; i != _n_dofs; ++i)
+    {
+      values[i].resize (_n_qp);
+
+      const T* in = &_storage[_offset + i*_stride];
+      T* out = _n_qp ? &values[i][0] : NULL;
+
+      for (unsigned int qp=0; qp != _n_qp; ++qp)
+        out[qp] = in[qp];
+    }
+}
+
+
+} // namespace libMesh
+
+#endif // #ifndef __fe_shape_block_h__
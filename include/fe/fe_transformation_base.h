@@ -20,6 +20,7 @@
 
 #include "fe_base.h"
 #include "fe_type.h"
+#include "fe_shape_block.h"
 
 namespace libMesh
 {
@@ -59,6 +60,18 @@ namespace libMesh
 			  const std::vector<Point>& qp,
 			  const FEGenericBase<OutputShape>& fe, 
 			  std::vector<std::vector<OutputShape> >& phi ) const = 0;
+
+    /**
+     * Evaluates shape functions in physical coordinates directly into
+     * the packed block \p phi, which must already be sized.  The default
+     * implementation evaluates into temporary vectors and packs them;
+     * derived classes should override it to write the block in place.
+     */
+    virtual void map_phi( const unsigned int dim,
+			  const Elem* const elem,
+			  const std::vector<Point>& qp,
+			  const FEGenericBase<OutputShape>& fe,
+			  FEShapeBlock<OutputShape>& phi ) const;
  
     /**
      * Evaluates shape function gradients in physical coordinates based on proper
@@ -73,6 +86,20 @@ namespace libMesh
 			   std::vector<std::vector<OutputShape> >& dphidy, 
 			   std::vector<std::vector<OutputShape> >& dphidz  ) const = 0;
 
+    /**
+     * Evaluates the components of the shape function gradients in
+     * physical coordinates directly into the packed blocks, which must
+     * already be sized.  The default implementation evaluates into
+     * temporary vectors and packs them.
+     */
+    virtual void map_dphi( const unsigned int dim,
+			   const Elem* const elem,
+			   const std::vector<Point>& qp,
+			   const FEGenericBase<OutputShape>& fe,
+			   FEShapeBlock<OutputShape>& dphidx,
+			   FEShapeBlock<OutputShape>& dphidy,
+			   FEShapeBlock<OutputShape>& dphidz ) const;
+
 #ifdef LIBMESH_ENABLE_SECOND_DERIVATIVES
     /**
      * Evaluates shape function Hessians in physical coordinates based on proper
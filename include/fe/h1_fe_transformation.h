@@ -50,6 +50,16 @@ namespace libMesh
 			  const std::vector<Point>&,
 			  const FEGenericBase<OutputShape>&,
 			  std::vector<std::vector<OutputShape> >& ) const;
+
+    /**
+     * Evaluates shape functions in physical coordinates for H1 conforming
+     * elements directly into the packed block \p phi.
+     */
+    virtual void map_phi( const unsigned int dim,
+			  const Elem* const elem,
+			  const std::vector<Point>& qp,
+			  const FEGenericBase<OutputShape>& fe,
+			  FEShapeBlock<OutputShape>& phi ) const;
     
     /**
      * Evaluates shape function gradients in physical coordinates for H1 conforming 
@@ -64,6 +74,19 @@ namespace libMesh
 			   std::vector<std::vector<OutputShape> >& dphidy, 
 			   std::vector<std::vector<OutputShape> >& dphidz) const;
 
+    /**
+     * Evaluates the components of the shape function gradients in
+     * physical coordinates for H1 conforming elements directly into
+     * the packed blocks.
+     */
+    virtual void map_dphi( const unsigned int dim,
+			   const Elem* const elem,
+			   const std::vector<Point>& qp,
+			   const FEGenericBase<OutputShape>& fe,
+			   FEShapeBlock<OutputShape>& dphidx,
+			   FEShapeBlock<OutputShape>& dphidy,
+			   FEShapeBlock<OutputShape>& dphidz ) const;
+
 #ifdef LIBMESH_ENABLE_SECOND_DERIVATIVES
     /**
      * Evaluates shape function Hessians in physical coordinates based on H1 conforming
@@ -164,6 +164,19 @@ public:
     return *this;
   }
 
+  /**
+   * Resets the \p StoredRange to contain the objects of \p objs, e.g.
+   * a subset of a range which was selected elsewhere.  Returns a
+   * reference to itself for convenience.
+   */
+  StoredRange<iterator_type, object_type> &
+  reset (const std::vector<object_type> &objs)
+  {
+    _objs = objs;
+
+    return this->reset();
+  }
+
   /**
    * Resets the range to the last specified range.  This method only exists
    * for efficiency -- it is more efficient to set the range to its previous
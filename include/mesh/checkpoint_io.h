@@ -0,0 +1,182 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef __checkpoint_io_h__
+#define __checkpoint_io_h__
+
+
+// Local includes
+#include "libmesh.h"
+#include "mesh_input.h"
+#include "mesh_output.h"
+
+// C++ includes
+#include <string>
+#include <vector>
+
+namespace libMesh
+{
+
+// Forward declarations
+class MeshBase;
+class EquationSystems;
+class MappedFile;
+
+
+/**
+ * This class reads and writes restart files in a native binary
+ * format.  Each processor writes the elements, nodes and boundary
+ * conditions it owns, and the local part of each vector of each
+ * system, as one slab of fixed-width arrays in the byte order of the
+ * machine.  The arrays are read in place from the memory-mapped
+ * file, without being parsed or copied.
+ *
+ * Element and node ids and processor ids are kept, so to restart
+ * from a file the mesh should not be renumbered or repartitioned
+ * after reading it:
+   \verbatim
+
+   mesh.skip_partitioning(true);
+   CheckpointIO(mesh).read ("restart.cpr");
+   mesh.prepare_for_use();
+
+   EquationSystems es(mesh);
+   // ... add the same systems, variables and vectors as before ...
+   es.init();
+
+   CheckpointIO(mesh).read_data ("restart.cpr", es);
+
+   \endverbatim
+ * The mesh can be read on any number of processors, but the data
+ * must be read on as many processors as wrote it, each of which
+ * reads only its own slab.
+ *
+ * The files are not portable between machines of different byte
+ * order or with a different \p Number type.
+ */
+
+// ------------------------------------------------------------
+// CheckpointIO class definition
+class CheckpointIO : public MeshInput<MeshBase>,
+		     public MeshOutput<MeshBase>
+{
+
+ public:
+
+  /**
+   * Constructor.  Takes a writeable reference to a mesh object.
+   * This is the constructor required to read a mesh.
+   */
+  explicit
+  CheckpointIO (MeshBase&);
+
+  /**
+   * Constructor.  Takes a reference to a constant mesh object.
+   * This constructor will only allow us to write the mesh.
+   */
+  explicit
+  CheckpointIO (const MeshBase&);
+
+  /**
+   * Destructor.
+   */
+  virtual ~CheckpointIO ();
+
+  /**
+   * This method implements reading a mesh from a specified file.
+   */
+  virtual void read (const std::string&);
+
+  /**
+   * This method implements writing a mesh to a specified file.
+   */
+  virtual void write (const std::string&);
+
+  /**
+   * Writes the mesh and the solution and additional vectors of
+   * every system in \p es to a specified file.
+   */
+  virtual void write_equation_systems (const std::string&,
+				       const EquationSystems&);
+
+  /**
+   * Reads the vectors written by \p write_equation_systems() into
+   * the systems of \p es with the same names, which must have the
+   * same degrees of freedom, distributed in the same way, as when
+   * they were written.  Vectors the systems do not have are skipped.
+   */
+  void read_data (const std::string&, EquationSystems&);
+
+  /**
+   * The part of a checkpoint file one processor writes, staged in
+   * memory.
+   */
+  struct StagedFile
+  {
+    /**
+     * The file header, on processor 0 only.
+     */
+    std::vector<char> header;
+
+    /**
+     * The slab of this processor, and where it goes in the file.
+     */
+    std::vector<char> slab;
+    unsigned long int slab_offset;
+  };
+
+  /**
+   * Copies the mesh, and the vectors of \p es if it is not NULL,
+   * into \p staged, and creates the empty file \p name.  Must be
+   * called on all processors; each can then \p write_staged() on
+   * its own.
+   */
+  void stage (const std::string &name,
+	      StagedFile &staged,
+	      const EquationSystems *es) const;
+
+  /**
+   * Writes the part of the file \p name staged in \p staged.  Uses
+   * nothing but \p staged, so it may run on any thread.
+   * @returns false on failure.
+   */
+  static bool write_staged (const std::string &name,
+			    const StagedFile &staged);
+
+
+ private:
+
+  /**
+   * Writes the mesh, and the vectors of \p es if it is not NULL.
+   */
+  void write_file (const std::string &name,
+		   const EquationSystems *es) const;
+
+  /**
+   * Maps the file \p name and checks its header.
+   */
+  void open_file (const std::string &name,
+		  MappedFile &file) const;
+};
+
+
+
+} // namespace libMesh
+
+#endif // #define __checkpoint_io_h__
@@ -0,0 +1,161 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef __compact_mesh_storage_h__
+#define __compact_mesh_storage_h__
+
+// Local Includes -----------------------------------
+#include "libmesh_common.h"
+#include "enum_elem_type.h"
+
+// C++ Includes   -----------------------------------
+#include <vector>
+
+namespace libMesh
+{
+
+// forward declarations
+class Elem;
+class MeshBase;
+
+
+
+/**
+ * The \p CompactMeshStorage class holds the element connectivity of
+ * a mesh in flat arrays.  Elements are grouped into one \p Block per
+ * \p ElemType, and each block stores the element ids and the node
+ * ids of its elements contiguously with a fixed stride, so loops
+ * over connectivity stream through memory instead of visiting every
+ * \p Elem on the heap.
+ *
+ * Only the element-to-node connectivity is stored.  Node coordinates,
+ * subdomain ids and neighbor links can be changed through the \p Node
+ * and \p Elem objects without the mesh knowing, so a copy of them
+ * could not be kept up to date.
+ *
+ * The storage is updated element by element with \p add_elem(),
+ * \p remove_elem() and \p renumber_elem(); \p SerialMesh does this
+ * as elements are added, deleted and renumbered.
+ */
+
+// ------------------------------------------------------------
+// CompactMeshStorage class definition
+class CompactMeshStorage
+{
+public:
+
+  /**
+   * Flat storage for all the elements of a single \p ElemType.
+   * Entry \p i of \p elem_ids is the id of the element whose nodes
+   * are \p connectivity[i*n_nodes ... (i+1)*n_nodes-1].  Elements
+   * are not kept in any particular order within a block.
+   */
+  struct Block
+  {
+    ElemType type;
+    unsigned int n_nodes;
+
+    std::vector<unsigned int> elem_ids;
+    std::vector<unsigned int> connectivity;
+
+    /**
+     * @returns the number of elements in this block.
+     */
+    unsigned int n_elem () const { return elem_ids.size(); }
+
+    /**
+     * @returns a pointer to the \p n_nodes node ids of the
+     * \p i-th element in this block.
+     */
+    const unsigned int* nodes (const unsigned int i) const
+    { libmesh_assert (i < this->n_elem()); return &connectivity[i*n_nodes]; }
+  };
+
+  /**
+   * Constructor.  Creates empty storage.
+   */
+  CompactMeshStorage ();
+
+  /**
+   * Discards any existing data and stores all the elements of
+   * \p mesh.
+   */
+  void build (const MeshBase& mesh);
+
+  /**
+   * Deletes all the data that are currently stored.
+   */
+  void clear ();
+
+  /**
+   * Stores the connectivity of \p elem, which must not be stored
+   * already.
+   */
+  void add_elem (const Elem* elem);
+
+  /**
+   * Removes the element with id \p elem_id.  The last element of its
+   * block is moved into the freed slot.
+   */
+  void remove_elem (const unsigned int elem_id);
+
+  /**
+   * Changes the id of a stored element from \p old_id to \p new_id.
+   */
+  void renumber_elem (const unsigned int old_id,
+		      const unsigned int new_id);
+
+  /**
+   * @returns true if an element with id \p elem_id is stored.
+   */
+  bool contains (const unsigned int elem_id) const;
+
+  /**
+   * @returns the number of element type blocks.
+   */
+  unsigned int n_blocks () const { return _blocks.size(); }
+
+  /**
+   * @returns the \p b-th element type block.
+   */
+  const Block& block (const unsigned int b) const
+  { libmesh_assert (b < _blocks.size()); return _blocks[b]; }
+
+private:
+
+  /**
+   * The per-\p ElemType blocks.
+   */
+  std::vector<Block> _blocks;
+
+  /**
+   * Map from element id to block index and offset within the block.
+   * Ids without a stored element map to \p DofObject::invalid_id.
+   */
+  std::vector<unsigned int> _elem_block;
+  std::vector<unsigned int> _elem_offset;
+};
+
+
+
+} // namespace libMesh
+
+
+
+#endif // #define __compact_mesh_storage_h__
@@ -69,12 +69,14 @@ class GmshIO : public MeshInput<MeshBase>,
 
   /**
    * Reads in a mesh in the Gmsh *.msh format
-   * from the ASCII file given by name.
+   * from the ASCII or binary file given by name.
    *
    * Note that for this method to work (in 2d and 3d) you have to
    * explicitly set the mesh dimension prior to calling GmshIO::read()
    * and that Mesh::prepare_for_use() must be called after reading the
    * mesh and before using it.
+   *
+   * If \p distributed() is set this must be called on all processors.
    */
   virtual void read (const std::string& name);
 
@@ -104,14 +106,26 @@ class GmshIO : public MeshInput<MeshBase>,
    */
   bool & binary ();
 
+  /**
+   * Flag indicating whether every processor should read the file
+   * itself.  Into a \p ParallelMesh each processor then keeps only
+   * a contiguous range of the elements, in the order of the file,
+   * with their nodes and their ghost neighbors, so that the whole
+   * mesh is never held in memory on any one processor; nodes no
+   * element uses are dropped.  Element and node ids are the same as
+   * when the mesh is read in serial.  Any other mesh is read whole on
+   * every processor, which saves broadcasting it.
+   */
+  bool & distributed ();
+
 
 private:
   /**
    * Implementation of the read() function.  This function
    * is called by the public interface function and implements
-   * reading the file.
+   * reading the file, held in memory in [begin, end).
    */
-  virtual void read_mesh (std::istream& in);
+  virtual void read_mesh (const char *begin, const char *end);
 
   /**
    * This method implements writing a mesh to a
@@ -133,7 +147,10 @@ private:
    */
   bool _binary;
 
-
+  /**
+   * Flag to read on all processors.
+   */
+  bool _distributed;
 
 };
 
@@ -144,7 +161,8 @@ private:
 inline
 GmshIO::GmshIO (const MeshBase& mesh) :
   MeshOutput<MeshBase> (mesh),
-  _binary        (false)
+  _binary        (false),
+  _distributed   (false)
 {
 }
 
@@ -153,7 +171,8 @@ inline
 GmshIO::GmshIO (MeshBase& mesh) :
   MeshInput<MeshBase>  (mesh),
   MeshOutput<MeshBase> (mesh),
-  _binary (false)
+  _binary (false),
+  _distributed (false)
 {}
 
 inline
@@ -162,6 +181,12 @@ bool & GmshIO::binary ()
   return _binary;
 }
 
+inline
+bool & GmshIO::distributed ()
+{
+  return _distributed;
+}
+
 
 } // namespace libMesh
 
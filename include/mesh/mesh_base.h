@@ -23,6 +23,7 @@
 
 
 // Local Includes -----------------------------------
+#include "affine_map_cache.h" // AutoPtr needs a real declaration
 #include "auto_ptr.h"
 #include "dof_object.h" // for invalid_processor_id
 #include "enum_elem_type.h"
@@ -646,6 +647,28 @@ public:
    */
   void clear_point_locator ();
 
+  /**
+   * @returns the cache of geometric factors for the elements of this
+   * mesh which have an affine map, building it first if necessary.
+   * Once it has been requested, the cache is rebuilt by every
+   * subsequent \p prepare_for_use(), and so after each refinement
+   * step.  It is \e not updated when nodes are moved: code which
+   * moves nodes without calling \p prepare_for_use() afterwards
+   * gets stale factors until it calls \p clear_affine_map_cache()
+   * and requests the cache again.  Attach it to \p FE objects with
+   * \p FEAbstract::attach_affine_map_cache().  This should not be
+   * called in threaded code unless the cache has already been built.
+   */
+  const AffineMapCache& affine_map_cache () const;
+
+  /**
+   * Empties the affine map cache, if any, and stops it being
+   * rebuilt by \p prepare_for_use() until \p affine_map_cache() is
+   * called again.  \p FE objects using the cache fall back to
+   * computing the map.
+   */
+  void clear_affine_map_cache ();
+
   /**
    * Verify id and processor_id consistency of our elements and
    * nodes containers.
@@ -839,6 +862,14 @@ protected:
    */
   mutable AutoPtr<PointLocatorBase> _point_locator;
 
+  /**
+   * The affine map cache for this mesh.  Like \p _point_locator it is
+   * only built on request; once built the object itself is kept for
+   * the lifetime of the mesh, since \p FE objects may hold pointers
+   * to it.
+   */
+  mutable AutoPtr<AffineMapCache> _affine_map_cache;
+
   /**
    * A partitioner to use at each prepare_for_use().
    *
@@ -117,7 +117,9 @@ namespace MeshTools
    * After calling this function the input vector \p nodes_to_elem_map
    * will contain the node to element connectivity.  That is to say
    * \p nodes_to_elem_map[i][j] is the global number of \f$ j^{th} \f$
-   * element connected to node \p i.
+   * element connected to node \p i.  For a \p SerialMesh which is
+   * keeping \p SerialMesh::compact_storage() the connectivity is
+   * read from there.
    */
   void build_nodes_to_elem_map (const MeshBase &mesh,
 				std::vector<std::vector<unsigned int> > &nodes_to_elem_map);
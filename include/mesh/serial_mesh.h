@@ -22,6 +22,7 @@
 
 // Local Includes -----------------------------------
 #include "unstructured_mesh.h"
+#include "compact_mesh_storage.h"
 
 // C++ Includes   -----------------------------------
 #include <cstddef>
@@ -137,6 +138,30 @@ class SerialMesh : public UnstructuredMesh
      */
   virtual void fix_broken_node_and_element_numbering ();
 
+  /**
+   * @returns the element connectivity in flat arrays.  The storage
+   * is built on first use; from then on it is updated as elements
+   * are added, deleted and renumbered through this class, until
+   * \p clear_compact_storage() is called.  Code which changes the
+   * nodes of an element that is already in the mesh must call
+   * \p clear_compact_storage() and request the storage again.
+   * Elements added since the last call are only stored when this is
+   * called, so it must not be called from several threads at once.
+   */
+  const CompactMeshStorage& compact_storage () const;
+
+  /**
+   * @returns true if \p compact_storage() has been called since the
+   * last \p clear_compact_storage(), so the storage is being kept.
+   */
+  bool has_compact_storage () const
+  { return _compact_storage.get() != NULL; }
+
+  /**
+   * Releases the compact storage, if any, and stops keeping it.
+   */
+  void clear_compact_storage ();
+
 public:
   /**
    * Elem iterator accessor functions.
@@ -316,6 +341,26 @@ protected:
    */
   std::vector<Elem*> _elements;
 
+  /**
+   * The compact element connectivity, if it is being kept.  Like the
+   * point locator this is built lazily from a \p const method, so it
+   * needs to be mutable.
+   */
+  mutable AutoPtr<CompactMeshStorage> _compact_storage;
+
+  /**
+   * Ids of the elements added since \p _compact_storage was last
+   * brought up to date.  Their nodes may not have been set yet when
+   * they were added, so they are stored on the next request.
+   */
+  mutable std::vector<unsigned int> _compact_storage_pending;
+
+  /**
+   * True if node ids may have changed since \p _compact_storage was
+   * built, so it needs to be rebuilt.
+   */
+  mutable bool _compact_storage_stale;
+
 private:
 
   /**
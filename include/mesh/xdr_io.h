@@ -101,7 +101,14 @@ class XdrIO : public MeshInput<MeshBase>,
   bool & legacy()       { return _legacy; }
 
   /**
-   * Report whether we should write parallel files.
+   * Report whether we should write parallel files.  In a parallel
+   * file each processor writes the elements, nodes and boundary
+   * conditions it owns as one slab, at an offset computed from the
+   * sizes of the slabs of the processors before it, and the header
+   * holds an index of the slabs.  Any number of processors can read
+   * it back, each reading a range of the slabs.  Parallel files
+   * cannot be compressed; a compressed file name gives a serialized
+   * file instead.
    */
   bool write_parallel() const;
 
@@ -122,8 +129,12 @@ class XdrIO : public MeshInput<MeshBase>,
 
      "libMesh-0.7.0+"
      "libMesh-0.7.0+ parallel"
+     "libMesh-0.7.0+ parallel slabs"
 
      \endverbatim
+     Files marked "parallel" hold the same serialized data as
+     unmarked ones; files marked "parallel slabs" hold one slab per
+     processor.
      If "libMesh" is not detected in the version string the
      \p LegacyXdrIO class will be used to read older
      (pre version 0.7.0) mesh files.
@@ -195,6 +206,38 @@ class XdrIO : public MeshInput<MeshBase>,
    */
   void read_serialized_bcs (Xdr &io);
 
+  //---------------------------------------------------------------------------
+  // Parallel Implementation
+  /**
+   * Write the elements, nodes and boundary conditions of this
+   * processor as its slab of the parallel file \p name, after
+   * the slab index, which processor 0 writes to \p io.
+   */
+  void write_parallel_slabs (Xdr &io, const std::string &name) const;
+
+  /**
+   * Read the slab index from \p io and then the slabs of the
+   * parallel file \p name, with each processor reading a range of
+   * the slabs, and build the mesh from all of them.
+   */
+  void read_parallel_slabs (Xdr &io, const std::string &name);
+
+  /**
+   * Read slabs \p first_slab through \p last_slab-1 of the parallel
+   * file \p name, described by \p slab_index, appending their
+   * element records to \p conn, their node ids and coordinates to
+   * \p node_ids and \p coords and their boundary conditions to
+   * \p bcs.  Any processor may read any range of slabs.
+   */
+  void read_slab_range (const std::string &name,
+			const std::vector<unsigned int> &slab_index,
+			const unsigned int first_slab,
+			const unsigned int last_slab,
+			std::vector<unsigned int> &conn,
+			std::vector<unsigned int> &node_ids,
+			std::vector<Real> &coords,
+			std::vector<int> &bcs) const;
+
   //-------------------------------------------------------------------------
   /**
    * Pack an element into a transfer buffer for parallel communication.
@@ -0,0 +1,153 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef __assembly_buffer_h__
+#define __assembly_buffer_h__
+
+// Local Includes
+#include "libmesh_common.h"
+
+// C++ includes
+#include <utility>
+#include <vector>
+
+namespace libMesh
+{
+
+// Forward Declarations
+template <typename T> class DenseMatrix;
+template <typename T> class DenseVector;
+template <typename T> class NumericVector;
+template <typename T> class SparseMatrix;
+
+
+
+/**
+ * Stages element matrices and vectors for insertion into a global
+ * \p SparseMatrix and \p NumericVector.  Each thread assembling a
+ * system keeps its own buffer, which needs no locking, and inserts
+ * it in bulk with \p flush().  The staged entries are summed by row
+ * and column there, so the global matrix receives each row once per
+ * flush, with sorted columns, through
+ * \p SparseMatrix::add_block_batch().
+ */
+
+// ------------------------------------------------------------
+// AssemblyBuffer class definition
+template <typename T>
+class AssemblyBuffer
+{
+public:
+
+  /**
+   * Constructor.  Creates an empty buffer.
+   */
+  AssemblyBuffer ();
+
+  /**
+   * Stages the element matrix \p dm, with rows and columns
+   * \p dof_indices.
+   */
+  void add_matrix (const DenseMatrix<T> &dm,
+		   const std::vector<unsigned int> &dof_indices);
+
+  /**
+   * Stages the element vector \p dv, with entries \p dof_indices.
+   */
+  void add_vector (const DenseVector<T> &dv,
+		   const std::vector<unsigned int> &dof_indices);
+
+  /**
+   * @returns the number of staged matrix and vector entries.
+   */
+  unsigned int n_entries () const
+  { return _block_values.size() + _vector_entries.size(); }
+
+  /**
+   * @returns true if nothing is staged.
+   */
+  bool empty () const
+  { return _blocks.empty() && _vector_entries.empty(); }
+
+  /**
+   * Adds the staged matrix entries to \p matrix and the staged vector
+   * entries to \p vector, then empties the buffer.  Either may be
+   * \p NULL if nothing was staged for it.  The caller is responsible
+   * for any locking the global objects need.
+   */
+  void flush (SparseMatrix<T> *matrix,
+	      NumericVector<T> *vector);
+
+  /**
+   * Discards the staged entries.
+   */
+  void clear ();
+
+private:
+
+  /**
+   * A staged element matrix: where its dof indices start in
+   * \p _block_dofs, how many there are, and where its row-major
+   * values start in \p _block_values.
+   */
+  struct Block
+  {
+    unsigned int dofs;
+    unsigned int n;
+    unsigned int values;
+  };
+
+  /**
+   * The staged element matrices.
+   */
+  std::vector<Block> _blocks;
+  std::vector<unsigned int> _block_dofs;
+  std::vector<T> _block_values;
+
+  /**
+   * The block each entry of \p _block_dofs belongs to.
+   */
+  std::vector<unsigned int> _dof_blocks;
+
+  /**
+   * The staged vector entries, in the order they were added.
+   */
+  std::vector<std::pair<unsigned int, T> > _vector_entries;
+
+  /**
+   * Work space for \p flush(): the distinct staged dofs, sorted, and
+   * the index in that list of each entry of \p _block_dofs; the
+   * block rows bucketed by row; a sparse accumulator for summing one
+   * row; and the summed rows in the form \p add_block_batch() takes.
+   * All but the last are indexed by position in the list of distinct
+   * dofs, not by dof.
+   */
+  std::vector<unsigned int> _local_dofs, _local_index;
+  std::vector<unsigned int> _row_counts, _row_items, _marker;
+  std::vector<T> _accumulator;
+  std::vector<unsigned int> _rows, _row_offsets, _cols, _merge_buffer;
+  std::vector<T> _values;
+  std::vector<unsigned int> _indices;
+  std::vector<std::pair<unsigned int, unsigned int> > _sorted_dofs;
+};
+
+
+} // namespace libMesh
+
+#endif // #ifndef __assembly_buffer_h__
@@ -95,6 +95,12 @@ public:
    */
   void close ();
 
+  /**
+   * Adding to different local entries of a \p DistributedVector from
+   * different threads is safe.
+   */
+  bool supports_concurrent_add() const { return true; }
+
   /**
    * @returns the \p DistributedVector to a pristine state.
    */
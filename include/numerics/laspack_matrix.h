@@ -96,6 +96,13 @@ public:
   bool need_full_sparsity_pattern() const
   { return true; }
 
+  /**
+   * The \p LaspackMatrix adds into preallocated rows, so
+   * threads adding to different rows do not interfere.
+   */
+  bool supports_concurrent_add() const
+  { return true; }
+
   /**
    * Updates the matrix sparsity pattern.  This will
    * tell the underlying matrix storage scheme how
@@ -207,6 +214,16 @@ public:
   void add_matrix (const DenseMatrix<T> &dm,
 		   const std::vector<unsigned int> &dof_indices);
 
+  /**
+   * Add a batch of sorted rows.  The sorted columns of each row are
+   * found in one pass over the stored row, instead of by a search
+   * per entry.
+   */
+  void add_block_batch (const std::vector<unsigned int> &rows,
+			const std::vector<unsigned int> &row_offsets,
+			const std::vector<unsigned int> &cols,
+			const std::vector<T> &values);
+
   /**
    * Add a Sparse matrix \p X, scaled with \p a, to \p this,
    * stores the result in \p this: \f$\texttt{this} += a*X \f$.
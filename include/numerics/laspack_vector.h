@@ -100,6 +100,12 @@ class LaspackVector : public NumericVector<T>
    */
   void close ();
 
+  /**
+   * Adding to different entries of a \p LaspackVector from different
+   * threads is safe.
+   */
+  bool supports_concurrent_add() const { return true; }
+
   /**
    * @returns the \p LaspackVector to a pristine state.
    */
@@ -125,6 +125,14 @@ public:
    */
   virtual bool closed() const { return _is_closed; }
 
+  /**
+   * @returns true if \p add() and \p add_vector() may be called
+   * from several threads at once, as long as no two threads add to
+   * the same entry.  This is false unless a derived class knows its
+   * insertion touches nothing shared between entries.
+   */
+  virtual bool supports_concurrent_add() const { return false; }
+
   /**
    * Call the assemble functions
    */
@@ -235,6 +235,15 @@ public:
   void add_matrix (const DenseMatrix<T> &dm,
 		   const std::vector<unsigned int> &dof_indices);
 
+  /**
+   * Add a batch of sorted rows, with one \p MatSetValues() call
+   * per row.
+   */
+  void add_block_batch (const std::vector<unsigned int> &rows,
+			const std::vector<unsigned int> &row_offsets,
+			const std::vector<unsigned int> &cols,
+			const std::vector<T> &values);
+
   /**
    * Add a Sparse matrix \p X, scaled with \p a, to \p this,
    * stores the result in \p this:
@@ -112,6 +112,15 @@ public:
   virtual bool need_full_sparsity_pattern() const
   { return false; }
 
+  /**
+   * @returns true if \p add() and \p add_matrix() may be called
+   * from several threads at once, as long as no two threads add to
+   * the same row.  This is false unless a derived class knows its
+   * insertion touches nothing shared between rows.
+   */
+  virtual bool supports_concurrent_add() const
+  { return false; }
+
   /**
    * Updates the matrix sparsity pattern. When your \p SparseMatrix<T>
    * implementation does not need this data simply do
@@ -227,6 +236,20 @@ public:
   virtual void add_matrix (const DenseMatrix<T> &dm,
 			   const std::vector<unsigned int> &dof_indices) = 0;
 
+  /**
+   * Add a batch of rows given in compressed row form: the entries
+   * of row \p rows[r] have columns \p cols[k] and values
+   * \p values[k] for \p row_offsets[r] <= k < \p row_offsets[r+1].
+   * The rows must be sorted and distinct, and so must the columns of
+   * each row.  This lets whole rows be inserted at once rather than
+   * element by element; see \p AssemblyBuffer.  The default
+   * implementation simply calls \p add() for each entry.
+   */
+  virtual void add_block_batch (const std::vector<unsigned int> &rows,
+				const std::vector<unsigned int> &row_offsets,
+				const std::vector<unsigned int> &cols,
+				const std::vector<T> &values);
+
   /**
    * Add a Sparse matrix \p _X, scaled with \p _a, to \p this,
    * stores the result in \p this:
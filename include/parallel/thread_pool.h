@@ -0,0 +1,103 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+#ifndef __thread_pool_h__
+#define __thread_pool_h__
+
+// Local includes
+#include "libmesh_config.h"
+
+#ifdef LIBMESH_HAVE_PTHREAD
+
+namespace libMesh
+{
+
+namespace Threads
+{
+
+  //-------------------------------------------------------------------
+  /**
+   * A unit of work for the \p ThreadPool.
+   */
+  class PoolTask
+  {
+  public:
+    virtual ~PoolTask () {}
+
+    /**
+     * Does the work.  May \p ThreadPool::spawn() more tasks.
+     */
+    virtual void execute () = 0;
+  };
+
+
+
+  //-------------------------------------------------------------------
+  /**
+   * The native thread pool behind \p Threads::parallel_for() and
+   * \p Threads::parallel_reduce() when libMesh is built without TBB.
+   * The thread calling \p run() and the helper threads each keep a
+   * deque of tasks.  A thread works on the newest task of its own
+   * deque and, when that is empty, steals the oldest task of another
+   * thread.  Since tasks split their range in half as they go, the
+   * oldest tasks are the largest, which keeps stealing rare.
+   *
+   * Only one \p run() may be in progress at a time.
+   */
+  class ThreadPool
+  {
+  public:
+
+    /**
+     * Starts \p n_threads-1 helper threads, or one fewer than the
+     * number of processors if \p n_threads is not positive.
+     */
+    static void start (const int n_threads);
+
+    /**
+     * Stops and joins the helper threads.
+     */
+    static void stop ();
+
+    /**
+     * @returns the number of threads working on a \p run(), including
+     * the calling thread, or 1 if the pool is not started.
+     */
+    static unsigned int n_threads ();
+
+    /**
+     * Adds \p task to the deque of the calling thread, which must be
+     * working on a \p run().  The pool deletes \p task once it has
+     * been executed.
+     */
+    static void spawn (PoolTask *task);
+
+    /**
+     * Executes \p root on the calling thread and helps with the tasks
+     * it spawns, returning once all of them are done.
+     */
+    static void run (PoolTask &root);
+  };
+
+} // namespace Threads
+
+} // namespace libMesh
+
+#endif // #ifdef LIBMESH_HAVE_PTHREAD
+
+#endif // #define __thread_pool_h__
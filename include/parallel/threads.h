@@ -31,10 +31,24 @@
 #  include "tbb/parallel_for.h"
 #  include "tbb/parallel_reduce.h"
 #  include "tbb/task_scheduler_init.h"
+#  include "tbb/tbb_thread.h"
 #  include "tbb/partitioner.h"
 #  include "tbb/spin_mutex.h"
 #  include "tbb/recursive_mutex.h"
 #  include "tbb/atomic.h"
+#  include "tbb/enumerable_thread_specific.h"
+#elif defined(LIBMESH_HAVE_PTHREAD)
+#  include "libmesh_logging.h" // only mess with the perflog if we are really multithreaded
+#  include "thread_pool.h"
+#  include <algorithm>
+#  include <pthread.h>
+#  include <vector>
+#endif
+
+// Defined when the Threads:: functions really run on multiple threads,
+// so code which is only needed then can be compiled out otherwise
+#if defined(LIBMESH_HAVE_TBB_API) || defined(LIBMESH_HAVE_PTHREAD)
+#  define LIBMESH_USING_THREADS
 #endif
 
 // C++ includes
@@ -99,7 +113,7 @@ namespace Threads
   {
     BoolAcquire b(in_threads);
 
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_PERFLOG_THREAD_AWARE)
     const bool logging_was_enabled = libMesh::perflog.logging_enabled();
 
     if (libMesh::n_threads() > 1)
@@ -112,7 +126,7 @@ namespace Threads
     else
       body(range);
 
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_PERFLOG_THREAD_AWARE)
     if (libMesh::n_threads() > 1 && logging_was_enabled)
       libMesh::perflog.enable_logging();
 #endif
@@ -131,7 +145,7 @@ namespace Threads
   {
     BoolAcquire b(in_threads);
 
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_PERFLOG_THREAD_AWARE)
     const bool logging_was_enabled = libMesh::perflog.logging_enabled();
 
     if (libMesh::n_threads() > 1)
@@ -144,7 +158,7 @@ namespace Threads
     else
       body(range);
 
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_PERFLOG_THREAD_AWARE)
     if (libMesh::n_threads() > 1 && logging_was_enabled)
       libMesh::perflog.enable_logging();
 #endif
@@ -163,7 +177,7 @@ namespace Threads
   {
     BoolAcquire b(in_threads);
 
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_PERFLOG_THREAD_AWARE)
     const bool logging_was_enabled = libMesh::perflog.logging_enabled();
 
     if (libMesh::n_threads() > 1)
@@ -176,7 +190,7 @@ namespace Threads
     else
       body(range);
 
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_PERFLOG_THREAD_AWARE)
     if (libMesh::n_threads() > 1 && logging_was_enabled)
       libMesh::perflog.enable_logging();
 #endif
@@ -195,7 +209,7 @@ namespace Threads
   {
     BoolAcquire b(in_threads);
 
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_PERFLOG_THREAD_AWARE)
     const bool logging_was_enabled = libMesh::perflog.logging_enabled();
 
     if (libMesh::n_threads() > 1)
@@ -208,7 +222,7 @@ namespace Threads
        else
 	 body(range);
 
-#ifdef LIBMESH_ENABLE_PERFORMANCE_LOGGING
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_PERFLOG_THREAD_AWARE)
     if (libMesh::n_threads() > 1 && logging_was_enabled)
       libMesh::perflog.enable_logging();
 #endif
@@ -216,6 +230,13 @@ namespace Threads
 
 
 
+  //-------------------------------------------------------------------
+  /**
+   * A thread running a copy of a function object.  Must be joined
+   * before it is destroyed.
+   */
+  typedef tbb::tbb_thread Thread;
+
   //-------------------------------------------------------------------
   /**
    * Spin mutex.  Implements mutual exclusion by busy-waiting in user
@@ -240,6 +261,444 @@ namespace Threads
   template <typename T>
   class atomic : public tbb::atomic<T> {};
 
+  //-------------------------------------------------------------------
+  /**
+   * A separate object of type \p T for each thread, created on first
+   * use by that thread.
+   */
+  template <typename T>
+  class enumerable_thread_specific : public tbb::enumerable_thread_specific<T> {};
+
+
+
+#elif defined(LIBMESH_HAVE_PTHREAD)
+
+  //-------------------------------------------------------------------
+  /**
+   * Scheduler to manage threads.  Starts the native thread pool,
+   * with \p n_threads threads, and stops it again when destroyed.
+   */
+  class task_scheduler_init
+  {
+  public:
+    static const int automatic = -1;
+    explicit task_scheduler_init (int n_threads = automatic)
+    { this->initialize (n_threads); }
+    ~task_scheduler_init () { this->terminate(); }
+    void initialize (int n_threads = automatic)
+    { ThreadPool::start (n_threads); }
+    void terminate () { ThreadPool::stop(); }
+  };
+
+  //-------------------------------------------------------------------
+  /**
+   * Dummy "splitting object" used to distinguish splitting constructors
+   * from copy constructors.
+   */
+  class split {};
+
+  //-------------------------------------------------------------------
+  /**
+   * The number of pieces \p parallel_for() and \p parallel_reduce()
+   * split a range into per thread, at most, so that threads which
+   * finish early can steal work from the others.
+   */
+  const unsigned int chunks_per_thread = 8;
+
+  //-------------------------------------------------------------------
+  /**
+   * Task which splits its range into \p n_chunks pieces, spawning a
+   * task for each but the first, and then runs its copy of the body
+   * on the first.
+   */
+  template <typename Range, typename Body>
+  class ParallelForTask : public PoolTask
+  {
+  public:
+    ParallelForTask (const Range &range, const Body &body,
+		     const unsigned int n_chunks) :
+      _range(range), _body(body), _n_chunks(n_chunks) {}
+
+    virtual void execute ()
+    {
+      while (_n_chunks > 1 && _range.is_divisible())
+	{
+	  Range right (_range, split());
+
+	  const unsigned int right_chunks = _n_chunks/2;
+	  ThreadPool::spawn (new ParallelForTask (right, _body, right_chunks));
+	  _n_chunks -= right_chunks;
+	}
+
+      _body (_range);
+    }
+
+  private:
+    Range _range;
+    Body _body;
+    unsigned int _n_chunks;
+  };
+
+  //-------------------------------------------------------------------
+  /**
+   * Joins a split-off body back into the body it was split from, once
+   * both are done with their ranges, and then reports to the join
+   * above it.  Deletes itself when done.
+   */
+  template <typename Body>
+  class ParallelReduceJoin
+  {
+  public:
+    ParallelReduceJoin (Body &left, ParallelReduceJoin *parent) :
+      _left(left), _right(left, split()), _parent(parent), _pending(2) {}
+
+    Body & right () { return _right; }
+
+    /**
+     * Called once for the left body and once for the right body when
+     * each is done.
+     */
+    void finish ()
+    {
+      if (__sync_sub_and_fetch (&_pending, 1))
+	return;
+
+      _left.join (_right);
+
+      ParallelReduceJoin *parent = _parent;
+      delete this;
+
+      if (parent)
+	parent->finish();
+    }
+
+  private:
+    Body &_left;
+    Body _right;
+    ParallelReduceJoin *_parent;
+    volatile int _pending;
+  };
+
+  //-------------------------------------------------------------------
+  /**
+   * Task which splits its range and its body into \p n_chunks pieces,
+   * spawning a task for each but the first, and then runs its body on
+   * the first.
+   */
+  template <typename Range, typename Body>
+  class ParallelReduceTask : public PoolTask
+  {
+  public:
+    ParallelReduceTask (const Range &range, Body &body,
+			const unsigned int n_chunks,
+			ParallelReduceJoin<Body> *done) :
+      _range(range), _body(body), _n_chunks(n_chunks), _done(done) {}
+
+    virtual void execute ()
+    {
+      while (_n_chunks > 1 && _range.is_divisible())
+	{
+	  Range right (_range, split());
+
+	  ParallelReduceJoin<Body> *join =
+	    new ParallelReduceJoin<Body> (_body, _done);
+
+	  const unsigned int right_chunks = _n_chunks/2;
+	  ThreadPool::spawn (new ParallelReduceTask (right, join->right(),
+						     right_chunks, join));
+	  _n_chunks -= right_chunks;
+	  _done = join;
+	}
+
+      _body (_range);
+
+      if (_done)
+	_done->finish();
+    }
+
+  private:
+    Range _range;
+    Body &_body;
+    unsigned int _n_chunks;
+    ParallelReduceJoin<Body> *_done;
+  };
+
+  //-------------------------------------------------------------------
+  /**
+   * Exectue the provided function object in parallel on the specified
+   * range.
+   */
+  template <typename Range, typename Body>
+  inline
+  void parallel_for (const Range &range, const Body &body)
+  {
+    BoolAcquire b(in_threads);
+
+    const unsigned int n_threads =
+      std::min (libMesh::n_threads(), ThreadPool::n_threads());
+
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_PERFLOG_THREAD_AWARE)
+    const bool logging_was_enabled = libMesh::perflog.logging_enabled();
+
+    if (n_threads > 1)
+      libMesh::perflog.disable_logging();
+#endif
+
+    if (n_threads > 1)
+      {
+	ParallelForTask<Range,Body> root (range, body,
+					  chunks_per_thread*n_threads);
+	ThreadPool::run (root);
+      }
+
+    else
+      body(range);
+
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_PERFLOG_THREAD_AWARE)
+    if (n_threads > 1 && logging_was_enabled)
+      libMesh::perflog.enable_logging();
+#endif
+  }
+
+  //-------------------------------------------------------------------
+  /**
+   * Exectue the provided function object in parallel on the specified
+   * range.  The native thread pool has no partitioners, so the
+   * partitioner is ignored.
+   */
+  template <typename Range, typename Body, typename Partitioner>
+  inline
+  void parallel_for (const Range &range, const Body &body, const Partitioner &)
+  {
+    parallel_for (range, body);
+  }
+
+  //-------------------------------------------------------------------
+  /**
+   * Exectue the provided reduction operation in parallel on the specified
+   * range.
+   */
+  template <typename Range, typename Body>
+  inline
+  void parallel_reduce (const Range &range, Body &body)
+  {
+    BoolAcquire b(in_threads);
+
+    const unsigned int n_threads =
+      std::min (libMesh::n_threads(), ThreadPool::n_threads());
+
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_PERFLOG_THREAD_AWARE)
+    const bool logging_was_enabled = libMesh::perflog.logging_enabled();
+
+    if (n_threads > 1)
+      libMesh::perflog.disable_logging();
+#endif
+
+    if (n_threads > 1)
+      {
+	ParallelReduceTask<Range,Body> root (range, body,
+					     chunks_per_thread*n_threads,
+					     NULL);
+	ThreadPool::run (root);
+      }
+
+    else
+      body(range);
+
+#if defined(LIBMESH_ENABLE_PERFORMANCE_LOGGING) && !defined(LIBMESH_PERFLOG_THREAD_AWARE)
+    if (n_threads > 1 && logging_was_enabled)
+      libMesh::perflog.enable_logging();
+#endif
+  }
+
+  //-------------------------------------------------------------------
+  /**
+   * Exectue the provided reduction operation in parallel on the specified
+   * range.  The native thread pool has no partitioners, so the
+   * partitioner is ignored.
+   */
+  template <typename Range, typename Body, typename Partitioner>
+  inline
+  void parallel_reduce (const Range &range, Body &body, const Partitioner &)
+  {
+    parallel_reduce (range, body);
+  }
+
+  //-------------------------------------------------------------------
+  /**
+   * A thread running a copy of a function object.  Must be joined
+   * before it is destroyed.
+   */
+  class Thread
+  {
+  public:
+    template <typename Callable>
+    explicit Thread (Callable f)
+    {
+      if (pthread_create (&_thread, NULL, run<Callable>, new Callable(f)))
+	{
+	  libMesh::err << "ERROR: could not start a thread" << std::endl;
+	  libmesh_error();
+	}
+    }
+
+    void join () { pthread_join (_thread, NULL); }
+
+  private:
+    template <typename Callable>
+    static void* run (void *f)
+    {
+      Callable *callable = static_cast<Callable*>(f);
+      (*callable)();
+      delete callable;
+      return NULL;
+    }
+
+    pthread_t _thread;
+
+    // Not copyable
+    Thread (const Thread&);
+    Thread& operator= (const Thread&);
+  };
+
+  //-------------------------------------------------------------------
+  /**
+   * Spin mutex.  Implements mutual exclusion by busy-waiting in user
+   * space for the lock to be acquired.
+   */
+  class spin_mutex
+  {
+  public:
+    spin_mutex() : _locked(0) {}
+    void lock () { while (__sync_lock_test_and_set (&_locked, 1)) while (_locked) {} }
+    void unlock () { __sync_lock_release (&_locked); }
+
+    class scoped_lock
+    {
+    public:
+      scoped_lock () : _mutex(NULL) {}
+      explicit scoped_lock ( spin_mutex& m ) : _mutex(NULL) { this->acquire(m); }
+      ~scoped_lock () { this->release(); }
+      void acquire ( spin_mutex& m ) { libmesh_assert(!_mutex); _mutex = &m; _mutex->lock(); }
+      void release () { if (_mutex) _mutex->unlock(); _mutex = NULL; }
+    private:
+      spin_mutex *_mutex;
+    };
+
+  private:
+    volatile int _locked;
+  };
+
+  //-------------------------------------------------------------------
+  /**
+   * Recursive mutex.  The same thread can aquire the same lock
+   * multiple times.
+   */
+  class recursive_mutex
+  {
+  public:
+    recursive_mutex()
+    {
+      pthread_mutexattr_t attr;
+      pthread_mutexattr_init (&attr);
+      pthread_mutexattr_settype (&attr, PTHREAD_MUTEX_RECURSIVE);
+      pthread_mutex_init (&_mutex, &attr);
+      pthread_mutexattr_destroy (&attr);
+    }
+    ~recursive_mutex() { pthread_mutex_destroy (&_mutex); }
+    void lock () { pthread_mutex_lock (&_mutex); }
+    void unlock () { pthread_mutex_unlock (&_mutex); }
+
+    class scoped_lock
+    {
+    public:
+      scoped_lock () : _mutex(NULL) {}
+      explicit scoped_lock ( recursive_mutex& m ) : _mutex(NULL) { this->acquire(m); }
+      ~scoped_lock () { this->release(); }
+      void acquire ( recursive_mutex& m ) { libmesh_assert(!_mutex); _mutex = &m; _mutex->lock(); }
+      void release () { if (_mutex) _mutex->unlock(); _mutex = NULL; }
+    private:
+      recursive_mutex *_mutex;
+    };
+
+  private:
+    pthread_mutex_t _mutex;
+
+    // Not copyable
+    recursive_mutex (const recursive_mutex&);
+    recursive_mutex& operator= (const recursive_mutex&);
+  };
+
+  //-------------------------------------------------------------------
+  /**
+   * Defines atomic operations which can only be executed on a
+   * single thread at a time.  This is used in reference counting,
+   * for example, to allow count++/count-- to work.
+   */
+  template <typename T>
+  class atomic
+  {
+  public:
+    atomic () : _val(0) {}
+    operator T () const { return _val; }
+    T operator= (T val) { _val = val; __sync_synchronize(); return val; }
+    T operator++ () { return __sync_add_and_fetch (&_val, 1); }
+    T operator-- () { return __sync_sub_and_fetch (&_val, 1); }
+    T operator++ (int) { return __sync_fetch_and_add (&_val, 1); }
+    T operator-- (int) { return __sync_fetch_and_sub (&_val, 1); }
+    T operator+= (T val) { return __sync_add_and_fetch (&_val, val); }
+    T operator-= (T val) { return __sync_sub_and_fetch (&_val, val); }
+  private:
+    volatile T _val;
+  };
+
+  //-------------------------------------------------------------------
+  /**
+   * A separate object of type \p T for each thread, created on first
+   * use by that thread.  The objects are deleted with this one.
+   */
+  template <typename T>
+  class enumerable_thread_specific
+  {
+  public:
+    enumerable_thread_specific () { pthread_key_create (&_key, NULL); }
+
+    ~enumerable_thread_specific ()
+    {
+      pthread_key_delete (_key);
+      for (unsigned int i=0; i != _values.size(); ++i)
+	delete _values[i];
+    }
+
+    T & local () { bool exists; return this->local(exists); }
+
+    T & local (bool &exists)
+    {
+      T *val = static_cast<T*>(pthread_getspecific (_key));
+      exists = (val != NULL);
+
+      if (!exists)
+	{
+	  val = new T();
+	  pthread_setspecific (_key, val);
+
+	  spin_mutex::scoped_lock lock(_mutex);
+	  _values.push_back (val);
+	}
+
+      return *val;
+    }
+
+  private:
+    pthread_key_t _key;
+    spin_mutex _mutex;
+    std::vector<T*> _values;
+
+    // Not copyable
+    enumerable_thread_specific (const enumerable_thread_specific&);
+    enumerable_thread_specific& operator= (const enumerable_thread_specific&);
+  };
+
 
 
 #else //LIBMESH_HAVE_TBB_API
@@ -316,6 +775,20 @@ namespace Threads
     body(range);
   }
 
+  //-------------------------------------------------------------------
+  /**
+   * A thread running a copy of a function object.  Without threads
+   * the function runs to completion in the constructor.
+   */
+  class Thread
+  {
+  public:
+    template <typename Callable>
+    explicit Thread (Callable f) { f(); }
+
+    void join () {}
+  };
+
   //-------------------------------------------------------------------
   /**
    * Spin mutex.  Implements mutual exclusion by busy-waiting in user
@@ -374,7 +847,7 @@ namespace Threads
   };
 
 
-#endif // #ifdef LIBMESH_HAVE_TBB_API
+#endif // #ifdef LIBMESH_HAVE_TBB_API, LIBMESH_HAVE_PTHREAD
 
 
 
@@ -0,0 +1,152 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef __async_checkpoint_writer_h__
+#define __async_checkpoint_writer_h__
+
+// Local Includes
+#include "libmesh_common.h"
+
+// C++ includes
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace libMesh
+{
+
+// Forward Declarations
+class EquationSystems;
+
+
+/**
+ * This class writes checkpoints of an \p EquationSystems object in
+ * the background.  \p write() copies the mesh and the vectors of
+ * every system into memory, as \p CheckpointIO would write them, and
+ * returns as soon as the copy is made; a separate thread then writes
+ * the file while the simulation goes on.  Without threads the file
+ * is written before \p write() returns.
+ *
+ * The staged copies take at most \p max_staged_bytes, not counting
+ * the one being staged: before a new checkpoint is handed to its
+ * thread, \p write() waits for older ones until it fits.
+ *
+   \verbatim
+
+   AsyncCheckpointWriter writer (es, 1 << 30);
+
+   for (unsigned int t=0; t != n_steps; ++t)
+     {
+       // ... solve ...
+
+       if (t % 10 == 0)
+         {
+           OStringStream name;
+           name << "step_" << t << ".cpr";
+           writer.write (name.str());
+         }
+     }
+
+   writer.wait ();
+
+   \endverbatim
+ */
+
+// ------------------------------------------------------------
+// AsyncCheckpointWriter class definition
+class AsyncCheckpointWriter
+{
+public:
+
+  /**
+   * Constructor.  Staged checkpoints of \p es take at most
+   * \p max_staged_bytes, or any amount if it is 0.
+   */
+  explicit
+  AsyncCheckpointWriter (const EquationSystems &es,
+			 const std::size_t max_staged_bytes = 0);
+
+  /**
+   * Destructor.  Waits for all checkpoints to be written.
+   */
+  ~AsyncCheckpointWriter ();
+
+  /**
+   * Stages a checkpoint of the mesh and of the solution and
+   * additional vectors of every system, to be written to the
+   * \p CheckpointIO file \p name in the background.  Must be called
+   * on all processors.  @returns a handle for the checkpoint.
+   */
+  unsigned int write (const std::string &name);
+
+  /**
+   * @returns true if this processor is done writing checkpoint
+   * \p handle.
+   */
+  bool done (const unsigned int handle) const;
+
+  /**
+   * Waits until this processor is done writing checkpoint \p handle,
+   * and frees its copy of the data.  The file is complete once every
+   * processor is done.
+   */
+  void wait (const unsigned int handle);
+
+  /**
+   * Waits until this processor is done writing all checkpoints.
+   */
+  void wait ();
+
+  /**
+   * A checkpoint being written.  Defined in
+   * async_checkpoint_writer.C.
+   */
+  class Job;
+
+private:
+
+  /**
+   * Joins the thread of checkpoint \p handle and frees its data.
+   * @returns false if writing it failed.
+   */
+  bool finish (const unsigned int handle);
+
+  const EquationSystems &_es;
+
+  const std::size_t _max_staged_bytes;
+
+  /**
+   * The bytes of the staged checkpoints not yet finished.
+   */
+  std::size_t _staged_bytes;
+
+  /**
+   * The checkpoints, by handle, or NULL once finished.
+   */
+  std::vector<Job*> _jobs;
+
+  // Not copyable
+  AsyncCheckpointWriter (const AsyncCheckpointWriter&);
+  AsyncCheckpointWriter& operator= (const AsyncCheckpointWriter&);
+};
+
+
+} // namespace libMesh
+
+#endif // #ifndef __async_checkpoint_writer_h__
@@ -102,10 +102,11 @@ public:
    * This is the time stored in the System class at the time this context
    * was created, i.e. the time at the beginning of the current timestep.
    * This value gets set in the constructor and unlike DiffContext::time,
-   * is not tweaked mid-timestep by transient solvers: it remains equal
-   * to the value it was assigned at construction.
+   * is not tweaked mid-timestep by transient solvers.  A context kept
+   * for reuse across timesteps must have it reset along with
+   * DiffContext::time, as FEMSystem::acquire_context() does.
    */
-  const Real system_time;
+  Real system_time;
 
   /**
    * Element by element components of nonlinear_solution
@@ -26,6 +26,7 @@
 
 // C++ includes
 #include <cstddef>
+#include <vector>
 
 namespace libMesh
 {
@@ -85,6 +86,12 @@ public:
    */
   virtual void clear ();
 
+  /**
+   * Reinitializes the member data fields associated with
+   * the system, so that, e.g., \p assemble() may be used.
+   */
+  virtual void reinit ();
+
   /**
    * Prepares \p matrix or \p rhs for matrix assembly.
    * Users may reimplement this to add pre- or post-assembly
@@ -288,6 +295,73 @@ public:
    */
   Real verify_analytic_jacobians;
 
+  /**
+   * If colored_assembly is true (it is false by default), threaded
+   * assembly works through the colors of
+   * \p DofMap::colored_elem_range() one at a time, and the elements
+   * of each color add to the global matrix and residual without
+   * locking.  This is only done if the matrix and residual both
+   * \p supports_concurrent_add(); otherwise assembly locks as usual.
+   * Also enabled with the \p --colored-assembly command line option.
+   */
+  bool colored_assembly;
+
+  /**
+   * If batched_assembly is true (it is false by default), each thread
+   * stages its element jacobians and residuals in an
+   * \p AssemblyBuffer and inserts them in bulk, sorted by row, at the
+   * end of its range.  This takes the assembly lock once per range
+   * rather than once per element.  Colored assembly takes precedence
+   * when both are enabled and usable.  Also enabled with the
+   * \p --batched-assembly command line option.
+   */
+  bool batched_assembly;
+
+  /**
+   * If reuse_contexts is true (it is false by default), the threaded
+   * element loops take their contexts from a pool kept by the system
+   * rather than building and initializing a new one for every range
+   * of elements.  The pool ends up with one context per thread and is
+   * kept across assemblies, so solves with many residual evaluations
+   * pay for building the contexts once.  A pooled context has its
+   * \p time and \p system_time reset to the system's \p time when it
+   * is handed out again, so the pool survives timesteps.  It is
+   * emptied by \p clear(), \p reinit() and \p init_data(); users
+   * who change anything else their \p build_context() or
+   * \p init_context() depends on, such as \p extra_quadrature_order,
+   * should call \p clear_context_pool().
+   * Also enabled with the \p --reuse-contexts command line option.
+   */
+  bool reuse_contexts;
+
+  /**
+   * The grain size of the element ranges used by the threaded
+   * element loops: a range of more elements than this may be split
+   * between threads.  Defaults to 1000, or to the value of the
+   * \p --assembly-grainsize command line option.
+   */
+  unsigned int assembly_grainsize;
+
+  /**
+   * @returns a context for an element loop: one from the pool if
+   * \p reuse_contexts is true and one is free, otherwise a new one
+   * from \p build_context() and \p init_context().  Hand it back
+   * with \p release_context().  May be called from multiple threads.
+   */
+  DiffContext* acquire_context ();
+
+  /**
+   * Returns a context from \p acquire_context() to the pool, or
+   * deletes it if \p reuse_contexts is false.  May be called from
+   * multiple threads.
+   */
+  void release_context (DiffContext* context);
+
+  /**
+   * Deletes the pooled contexts.
+   */
+  void clear_context_pool ();
+
   /**
    * Syntax sugar to make numerical_jacobian() declaration easier.
    */
@@ -320,6 +394,13 @@ protected:
    * the system, so that, e.g., \p assemble() may be used.
    */
   virtual void init_data ();
+
+private:
+  /**
+   * The contexts not currently in use, when \p reuse_contexts is
+   * true.
+   */
+  std::vector<DiffContext*> _context_pool;
 };
 
 
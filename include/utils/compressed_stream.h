@@ -0,0 +1,219 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef __compressed_stream_h__
+#define __compressed_stream_h__
+
+// Local Includes
+#include "libmesh_common.h"
+
+// C++ includes
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace libMesh
+{
+
+
+
+/**
+ * A stream buffer which reads or writes a file compressed with
+ * bzip2, xz or zstd, decompressing or compressing the data in this
+ * process as it passes through, the way gzstream does for gzip.
+ * Nothing is written to disk uncompressed.
+ *
+ * xz and zstd can compress on multiple threads, splitting the data
+ * into blocks which are compressed independently; newer versions of
+ * liblzma can decompress such xz files on multiple threads as well.
+ * Files holding several concatenated compressed streams, as written
+ * by parallel compressors, are read in full.
+ */
+
+// ------------------------------------------------------------
+// CompressedStreambuf class definition
+class CompressedStreambuf : public std::streambuf
+{
+public:
+
+  /**
+   * The compression formats.
+   */
+  enum Codec { BZIP2, XZ, ZSTD };
+
+  /**
+   * Sets \p codec from the extension of \p name: .bz2, .xz or .zst.
+   * @returns false if \p name has none of these.
+   */
+  static bool codec_of (const std::string &name, Codec &codec);
+
+  /**
+   * @returns true if the library for \p codec was found when libMesh
+   * was configured.
+   */
+  static bool available (const Codec codec);
+
+  /**
+   * Constructor.  Creates a closed buffer.
+   */
+  CompressedStreambuf ();
+
+  /**
+   * Destructor.  Closes the file.
+   */
+  ~CompressedStreambuf ();
+
+  /**
+   * Opens \p name for reading if \p mode includes \p std::ios::in,
+   * and for writing otherwise.  Compression uses up to \p n_threads
+   * threads if the codec supports it.  @returns NULL on failure.
+   */
+  CompressedStreambuf* open (const std::string &name,
+			     const std::ios_base::openmode mode,
+			     const Codec codec,
+			     const unsigned int n_threads = 1);
+
+  /**
+   * Finishes the compressed data, when writing, and closes the file.
+   * @returns NULL on failure.
+   */
+  CompressedStreambuf* close ();
+
+  /**
+   * @returns true if a file is open.
+   */
+  bool is_open () const { return _file != NULL; }
+
+  /**
+   * The compression or decompression state of one codec.  Defined
+   * in compressed_stream.C.
+   */
+  class CodecStream;
+
+protected:
+
+  /**
+   * Compresses the full put area, making room for \p c.
+   */
+  virtual int_type overflow (int_type c);
+
+  /**
+   * Refills the get area with decompressed data.
+   */
+  virtual int_type underflow ();
+
+  /**
+   * Compresses the put area.
+   */
+  virtual int sync ();
+
+private:
+
+  /**
+   * Compresses the put area and empties it.  If \p finish, also ends
+   * the compressed stream.
+   */
+  bool compress_buffer (const bool finish);
+
+  std::FILE *_file;
+
+  bool _writing;
+
+  CodecStream *_codec_stream;
+
+  /**
+   * The uncompressed data.
+   */
+  std::vector<char> _buffer;
+};
+
+
+
+/**
+ * An input stream reading a file through a \p CompressedStreambuf.
+ */
+class icompressedstream : public std::istream
+{
+public:
+
+  icompressedstream () : std::istream(&_buf) {}
+
+  /**
+   * Opens \p name, compressed with \p codec.
+   */
+  void open (const std::string &name,
+	     const CompressedStreambuf::Codec codec,
+	     const unsigned int n_threads = 1)
+  {
+    if (!_buf.open (name, std::ios::in, codec, n_threads))
+      this->setstate (std::ios::badbit);
+  }
+
+  void close ()
+  {
+    if (!_buf.close())
+      this->setstate (std::ios::badbit);
+  }
+
+private:
+
+  CompressedStreambuf _buf;
+};
+
+
+
+/**
+ * An output stream writing a file through a \p CompressedStreambuf.
+ */
+class ocompressedstream : public std::ostream
+{
+public:
+
+  ocompressedstream () : std::ostream(&_buf) {}
+
+  ~ocompressedstream () { _buf.close(); }
+
+  /**
+   * Creates \p name, compressed with \p codec on up to \p n_threads
+   * threads.
+   */
+  void open (const std::string &name,
+	     const CompressedStreambuf::Codec codec,
+	     const unsigned int n_threads = 1)
+  {
+    if (!_buf.open (name, std::ios::out, codec, n_threads))
+      this->setstate (std::ios::badbit);
+  }
+
+  void close ()
+  {
+    if (!_buf.close())
+      this->setstate (std::ios::badbit);
+  }
+
+private:
+
+  CompressedStreambuf _buf;
+};
+
+
+} // namespace libMesh
+
+#endif // #ifndef __compressed_stream_h__
@@ -0,0 +1,108 @@
+// The libMesh Finite Element Library.
+// Copyright (C) 2002-2012 Benjamin S. Kirk, John W. Peterson, Roy H. Stogner
+
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+
+
+#ifndef __mapped_file_h__
+#define __mapped_file_h__
+
+// Local Includes
+#include "libmesh_common.h"
+
+// C++ includes
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace libMesh
+{
+
+
+
+/**
+ * A read-only view of the contents of a file.  Where the system has
+ * \p mmap() the file is mapped into memory, so that only the pages
+ * actually touched are read from disk and no copy of the data is
+ * made; otherwise the whole file is read into a buffer.
+ */
+
+// ------------------------------------------------------------
+// MappedFile class definition
+class MappedFile
+{
+public:
+
+  /**
+   * Constructor.  Creates a closed file.
+   */
+  MappedFile ();
+
+  /**
+   * Destructor.  Closes the file.
+   */
+  ~MappedFile ();
+
+  /**
+   * Maps the file \p name.  @returns false on failure.
+   */
+  bool open (const std::string &name);
+
+  /**
+   * Unmaps the file.  Pointers into it are invalid afterwards.
+   */
+  void close ();
+
+  /**
+   * @returns true if a file is open.
+   */
+  bool is_open () const { return _data != NULL; }
+
+  /**
+   * @returns the contents of the file.
+   */
+  const char* data () const { return _data; }
+
+  /**
+   * @returns the size of the file in bytes.
+   */
+  std::size_t size () const { return _size; }
+
+private:
+
+  const char *_data;
+
+  std::size_t _size;
+
+  /**
+   * True if \p _data is mapped rather than pointing into \p _buffer.
+   */
+  bool _mapped;
+
+  /**
+   * The contents of the file, if it could not be mapped.
+   */
+  std::vector<char> _buffer;
+
+  // Not copyable
+  MappedFile (const MappedFile&);
+  MappedFile& operator= (const MappedFile&);
+};
+
+
+} // namespace libMesh
+
+#endif // #ifndef __mapped_file_h__
@@ -23,13 +23,23 @@
 
 // Local includes
 #include "libmesh_common.h"
+#include "perfmon.h"
 
 // C++ includes
 #include <cstddef>
 #include <map>
-#include <stack>
 #include <string>
+#include <vector>
+#include <stdint.h>
 #include <sys/time.h>
+#include <time.h>
+
+// Event stacks are kept per thread when the compiler provides
+// thread-local storage, in which case logging may stay enabled
+// inside Threads::parallel_for() and friends.
+#ifdef LIBMESH_TLS
+#  define LIBMESH_PERFLOG_THREAD_AWARE
+#endif
 
 namespace libMesh
 {
@@ -51,12 +61,16 @@ class PerfData
   PerfData () :
     tot_time(0.),
     tot_time_incl_sub(0.),
-    tstart(),
-    tstart_incl_sub(),
+    tstart(0),
+    tstart_incl_sub(0),
     count(0),
     open(false),
-    called_recursively(0)
-    {}
+    called_recursively(0),
+    counting(false)
+    {
+      for (unsigned int c=0; c != HardwareCounters::N_COUNTERS; ++c)
+	counters[c] = counters_start[c] = 0;
+    }
 
 
   /**
@@ -70,16 +84,16 @@ class PerfData
   double tot_time_incl_sub;
 
   /**
-   * Structure defining when the event
-   * was last started.
+   * When the event was last started, in nanoseconds
+   * as returned by \p now().
    */
-  struct timeval tstart;
+  uint64_t tstart;
 
   /**
-   * Structure defining when the event
-   * was last started, including sub-events.
+   * When the event was last started, including sub-events,
+   * in nanoseconds as returned by \p now().
    */
-  struct timeval tstart_incl_sub;
+  uint64_t tstart_incl_sub;
 
   /**
    * The number of times this event has
@@ -101,8 +115,44 @@ class PerfData
 
   int called_recursively;
 
+  /**
+   * Hardware counter totals for this event, excluding sub-events,
+   * when the log counts them.
+   */
+  uint64_t counters[HardwareCounters::N_COUNTERS];
+
+  /**
+   * Start (or resume) counting with current counter values \p values.
+   */
+  void begin_counting (const uint64_t* values);
+
+  /**
+   * Stop (or pause) counting with current counter values \p values,
+   * adding the counts since the last \p begin_counting().
+   */
+  void end_counting (const uint64_t* values);
+
+  /**
+   * Adds the totals and counts of \p other to this event.
+   * Used to merge the data of different threads.
+   */
+  PerfData& operator+= (const PerfData& other);
+
+  /**
+   * @returns the current time in nanoseconds from a monotonic
+   * clock, falling back to \p gettimeofday() where no such clock is
+   * available.
+   */
+  static uint64_t now ();
+
  protected:
   double stop_or_pause(const bool do_stop);
+
+  /**
+   * Counter values when counting last began, and whether it has.
+   */
+  uint64_t counters_start[HardwareCounters::N_COUNTERS];
+  bool counting;
 };
 
 
@@ -115,6 +165,25 @@ class PerfData
  * This class is particulary useful for finding performance
  * bottlenecks.
  *
+ * Each event is assigned an integer handle the first time it is
+ * seen; \p get_event_id() returns it, and \p push() and \p pop()
+ * accept it directly, so frequently logged events avoid looking up
+ * their names.  The \p START_LOG and \p STOP_LOG macros resolve the
+ * handle once per call site.
+ *
+ * Every thread records its events on its own stack with its own
+ * totals, which \p get_perf_info() merges.  Times are summed over
+ * threads, so with several threads active the reported active time
+ * may exceed the wall clock time.
+ *
+ * With \p enable_hardware_counters() each event also accumulates
+ * processor counter values (see \p HardwareCounters), and the log
+ * prints the instructions per cycle, cache miss rate, branch misses
+ * and an estimate of memory bandwidth for each event.
+ *
+ * In addition to the aggregated table, the log can record a
+ * timeline of individual events (see \p enable_timeline()), which
+ * \p write_timeline() saves in the Chrome trace event format.
  */
 
 // ------------------------------------------------------------
@@ -163,18 +232,38 @@ class PerfLog
    */
   bool logging_enabled() const { return log_events; }
 
+  /**
+   * @returns the handle of the event \p label in group \p header,
+   * registering the event first if necessary.  Handles remain valid
+   * across \p clear().
+   */
+  unsigned int get_event_id (const std::string &label,
+			     const std::string &header="");
+
   /**
    * Push the event \p label onto the stack, pausing any active event.
    */
   void push (const std::string &label,
 	     const std::string &header="");
 
+  /**
+   * Push the event with handle \p event_id onto the stack of the
+   * calling thread, pausing any active event of that thread.
+   */
+  void push (const unsigned int event_id);
+
   /**
    * Pop the event \p label off the stack, resuming any lower event.
    */
   void pop (const std::string &label,
 	    const std::string &header="");
 
+  /**
+   * Pop the event with handle \p event_id off the stack of the
+   * calling thread, resuming any lower event.
+   */
+  void pop (const unsigned int event_id);
+
   /**
    * Start monitoring the event named \p label.
    */
@@ -199,6 +288,54 @@ class PerfLog
   void restart_event(const std::string &label,
 		     const std::string &header="");
 
+  /**
+   * Starts counting hardware events for every logged event.  Reading
+   * the counters costs a system call per \p push() and \p pop(), so
+   * this is best reserved for coarse events.  Events already running
+   * when counting starts are not counted.
+   */
+  void enable_hardware_counters () { count_hardware = true; }
+
+  /**
+   * Stops counting hardware events.
+   */
+  void disable_hardware_counters () { count_hardware = false; }
+
+  /**
+   * Returns true iff hardware events are being counted.
+   */
+  bool hardware_counters_enabled() const { return count_hardware; }
+
+  /**
+   * Starts recording every completed event with its start and stop
+   * times and the thread that ran it.  Each thread keeps only its
+   * last \p capacity events in a ring buffer, so memory use stays
+   * fixed on long runs.  Must not be called while other threads are
+   * logging events.
+   */
+  void enable_timeline (const unsigned int capacity = 65536);
+
+  /**
+   * Stops recording the timeline and discards the recorded events.
+   */
+  void disable_timeline ();
+
+  /**
+   * Returns true iff the timeline is being recorded.
+   */
+  bool timeline_enabled() const { return timeline_capacity != 0; }
+
+  /**
+   * Writes the recorded timeline of this processor to \p filename
+   * as Chrome trace event JSON, which can be loaded in
+   * chrome://tracing or Perfetto.  Events are labelled with
+   * \p libMesh::processor_id() as the process id and the thread slot
+   * as the thread id, and times are relative to the construction or
+   * last \p clear() of this log.  Use the \p trace_merge application
+   * to combine the files written by several processors.
+   */
+  void write_timeline (const std::string& filename) const;
+
   /**
    * @returns a string containing:
    * (1) Basic machine information (if first call)
@@ -229,6 +366,85 @@ class PerfLog
 
  private:
 
+  /**
+   * A completed event in the timeline.
+   */
+  struct TimelineEvent
+  {
+    unsigned int event_id;
+    uint64_t start;
+    uint64_t stop;
+  };
+
+  /**
+   * The events and the event stack recorded by a single thread.
+   */
+  struct ThreadLog
+  {
+    ThreadLog () : total_time(0.), n_timeline_events(0), counters(NULL) {}
+
+    ~ThreadLog () { delete counters; }
+
+    /**
+     * Data for each event, indexed by event handle.
+     */
+    std::vector<PerfData> data;
+
+    /**
+     * The handles of the currently running events and the times
+     * they were started.
+     */
+    std::vector<unsigned int> stack;
+    std::vector<uint64_t> stack_start;
+
+    /**
+     * The total running time for events recorded by this thread.
+     */
+    double total_time;
+
+    /**
+     * Ring buffer of completed events, and the number of events ever
+     * stored in it.
+     */
+    std::vector<TimelineEvent> timeline;
+    std::size_t n_timeline_events;
+
+    /**
+     * The hardware counters of this thread, opened on first use.
+     */
+    HardwareCounters* counters;
+  };
+
+  /**
+   * @returns the \p ThreadLog of the calling thread, creating it
+   * first if necessary.
+   */
+  ThreadLog& thread_log ();
+
+  /**
+   * @returns the \p ThreadLog of thread slot \p slot, or \p NULL if
+   * that thread has not logged anything.
+   */
+  ThreadLog* find_thread_log (const unsigned int slot) const;
+
+  /**
+   * @returns the data of all threads merged and keyed by
+   * (header, label), and the summed active time in \p total_time.
+   */
+  std::map<std::pair<std::string, std::string>, PerfData>
+  merged_log (double& total_time) const;
+
+  /**
+   * Reads the hardware counters of the thread owning \p tlog into
+   * \p values, opening them first if necessary.
+   */
+  static void read_counters (ThreadLog& tlog, uint64_t* values);
+
+  /**
+   * @returns the hardware counter table for \p log.
+   */
+  std::string get_counter_info
+  (const std::map<std::pair<std::string, std::string>, PerfData>& log) const;
 
   /**
    * The label for this object.
@@ -241,26 +457,40 @@ class PerfLog
   bool log_events;
 
   /**
-   * The total running time for recorded events.
+   * The time we were constructed or last cleared, in nanoseconds.
+   */
+  uint64_t tstart;
+
+  /**
+   * The (header, label) of each registered event, indexed by handle,
+   * and the reverse map used to assign handles.
    */
-  double total_time;
+  std::vector<std::pair<std::string, std::string> > event_names;
+  std::map<std::pair<std::string, std::string>, unsigned int> event_ids;
 
   /**
-   * The time we were constructed or last cleared.
+   * The number of chunks in \p thread_logs.
    */
-  struct timeval tstart;
+  static const unsigned int n_thread_log_chunks = 24;
 
   /**
-   * The actual log.
+   * The per-thread logs, indexed by thread slot.  The slots are
+   * split into chunks of doubling size which are allocated when
+   * first needed, so that the table grows with the number of
+   * threads without moving entries other threads are using.
    */
-  std::map<std::pair<std::string,
-		     std::string>,
-	   PerfData> log;
+  ThreadLog** thread_logs[n_thread_log_chunks];
 
   /**
-   * A stack to hold the current performance log trace.
+   * The number of timeline events kept per thread, or zero if the
+   * timeline is not being recorded.
    */
-  std::stack<PerfData*> log_stack;
+  unsigned int timeline_capacity;
+
+  /**
+   * Flag to count hardware events.
+   */
+  bool count_hardware;
 
   /**
    * Flag indicating if print_log() has been called.
@@ -274,12 +504,32 @@ class PerfLog
 
 // ------------------------------------------------------------
 // PerfData class member funcions
+inline
+uint64_t PerfData::now ()
+{
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+
+  return static_cast<uint64_t>(ts.tv_sec)*1000000000 +
+         static_cast<uint64_t>(ts.tv_nsec);
+#else
+  struct timeval tv;
+  gettimeofday (&tv, NULL);
+
+  return static_cast<uint64_t>(tv.tv_sec)*1000000000 +
+         static_cast<uint64_t>(tv.tv_usec)*1000;
+#endif
+}
+
+
+
 inline
 void PerfData::start ()
 {
   this->count++;
   this->called_recursively++;
-  gettimeofday (&(this->tstart), NULL);
+  this->tstart = now();
   this->tstart_incl_sub = this->tstart;
 }
 
@@ -288,7 +538,7 @@ void PerfData::start ()
 inline
 void PerfData::restart ()
 {
-  gettimeofday (&(this->tstart), NULL);
+  this->tstart = now();
 }
 
 
@@ -303,23 +553,17 @@ double PerfData::pause ()
 inline
 double PerfData::stop_or_pause(const bool do_stop)
 {
-  // save the start times, reuse the structure we have rather than create
-  // a new one.
-  const time_t
-    tstart_tv_sec  = this->tstart.tv_sec,
-    tstart_tv_usec = this->tstart.tv_usec;
+  const uint64_t tstop = now();
 
-  gettimeofday (&(this->tstart), NULL);
-
-  const double elapsed_time = (static_cast<double>(this->tstart.tv_sec  - tstart_tv_sec) +
-			       static_cast<double>(this->tstart.tv_usec - tstart_tv_usec)*1.e-6);
+  const double elapsed_time = static_cast<double>(tstop - this->tstart)*1.e-9;
 
+  this->tstart = tstop;
   this->tot_time += elapsed_time;
 
   if(do_stop)
     {
-      const double elapsed_time_incl_sub = (static_cast<double>(this->tstart.tv_sec  - this->tstart_incl_sub.tv_sec) +
-					    static_cast<double>(this->tstart.tv_usec - this->tstart_incl_sub.tv_usec)*1.e-6);
+      const double elapsed_time_incl_sub =
+	static_cast<double>(tstop - this->tstart_incl_sub)*1.e-9;
 
       this->tot_time_incl_sub += elapsed_time_incl_sub;
     }
@@ -341,74 +585,70 @@ double PerfData::stopit ()
 
 
 
-// ------------------------------------------------------------
-// PerfLog class inline member funcions
 inline
-void PerfLog::push (const std::string &label,
-		    const std::string &header)
+void PerfData::begin_counting (const uint64_t* values)
 {
-  if (this->log_events)
-    {
-      // Get a reference to the event data to avoid
-      // repeated map lookups
-      PerfData *perf_data = &(log[std::make_pair(header,label)]);
+  for (unsigned int c=0; c != HardwareCounters::N_COUNTERS; ++c)
+    this->counters_start[c] = values[c];
 
-      if (!log_stack.empty())
-	total_time +=
-	  log_stack.top()->pause();
+  this->counting = true;
+}
 
-      perf_data->start();
-      log_stack.push(perf_data);
-    }
+
+
+inline
+void PerfData::end_counting (const uint64_t* values)
+{
+  if (this->counting)
+    for (unsigned int c=0; c != HardwareCounters::N_COUNTERS; ++c)
+      this->counters[c] += values[c] - this->counters_start[c];
+
+  this->counting = false;
 }
 
 
 
 inline
-void PerfLog::pop (const std::string &libmesh_dbg_var(label),
-		   const std::string &libmesh_dbg_var(header))
+PerfData& PerfData::operator+= (const PerfData& other)
 {
-  if (this->log_events)
-    {
-      libmesh_assert (!log_stack.empty());
-
-#ifndef NDEBUG
-      PerfData *perf_data = &(log[std::make_pair(header,label)]);
-      if (perf_data != log_stack.top())
-        {
-          std::cerr << "PerfLog can't pop (" << header << ',' << label << ')' << std::endl;
-          std::cerr << "From top of stack of running logs:" << std::endl;
-          std::map<std::pair<std::string, std::string>, PerfData>::iterator
-            i = log.begin(), endi = log.end();
-          for (; i != endi; ++i)
-            if (&(i->second) == log_stack.top())
-              std::cerr << '(' << i->first.first << ',' << i->first.second << ')' << std::endl;
-
-          libmesh_assert(perf_data == log_stack.top());
-        }
-#endif
+  this->tot_time          += other.tot_time;
+  this->tot_time_incl_sub += other.tot_time_incl_sub;
+  this->count             += other.count;
 
-      total_time += log_stack.top()->stopit();
+  for (unsigned int c=0; c != HardwareCounters::N_COUNTERS; ++c)
+    this->counters[c] += other.counters[c];
 
-      log_stack.pop();
+  return *this;
+}
 
-      if (!log_stack.empty())
-	log_stack.top()->restart();
-    }
+
+
+// ------------------------------------------------------------
+// PerfLog class inline member funcions
+inline
+void PerfLog::push (const std::string &label,
+		    const std::string &header)
+{
+  if (this->log_events)
+    this->push(this->get_event_id(label, header));
 }
 
 
 
 inline
-double PerfLog::get_elapsed_time () const
+void PerfLog::pop (const std::string &label,
+		   const std::string &header)
 {
-  struct timeval tnow;
+  if (this->log_events)
+    this->pop(this->get_event_id(label, header));
+}
 
-  gettimeofday (&tnow, NULL);
 
-  const double elapsed_time = (static_cast<double>(tnow.tv_sec  - tstart.tv_sec) +
-			       static_cast<double>(tnow.tv_usec - tstart.tv_usec)*1.e-6);
-  return elapsed_time;
+
+inline
+double PerfLog::get_elapsed_time () const
+{
+  return static_cast<double>(PerfData::now() - tstart)*1.e-9;
 }
 
 
@@ -33,6 +33,7 @@ namespace Papi {
 // C++ includes
 #include <cstddef>
 #include <string>
+#include <stdint.h>
 #include <sys/time.h>
 
 namespace libMesh
@@ -40,6 +41,83 @@ namespace libMesh
 
 
 
+/**
+ * The \p HardwareCounters class reads the processor's performance
+ * counters for the calling thread.  On Linux systems providing
+ * \p perf_event_open() it counts cycles, instructions, last-level
+ * cache references and misses, and branch misses in user space;
+ * elsewhere, or when the kernel does not allow access to the
+ * counters (see /proc/sys/kernel/perf_event_paranoid), \p available()
+ * returns false and every count reads as zero.
+ *
+ * The counters only count the thread which constructed the object.
+ */
+
+// ------------------------------------------------------------
+// HardwareCounters class definition
+class HardwareCounters
+{
+ public:
+
+  /**
+   * The counted events.
+   */
+  enum Counter { CYCLES = 0,
+		 INSTRUCTIONS,
+		 CACHE_REFERENCES,
+		 CACHE_MISSES,
+		 BRANCH_MISSES,
+		 N_COUNTERS };
+
+  /**
+   * The number of bytes assumed to be transferred from memory for
+   * each last-level cache miss when estimating memory bandwidth.
+   */
+  static const unsigned int cache_line_size = 64;
+
+  /**
+   * Constructor.  Opens and starts the counters for the calling
+   * thread.
+   */
+  HardwareCounters ();
+
+  /**
+   * Destructor.  Releases the counters.
+   */
+  ~HardwareCounters ();
+
+  /**
+   * @returns true if the counters could be opened.
+   */
+  bool available () const { return _available; }
+
+  /**
+   * Stores the current value of each counter in \p values, which
+   * must hold \p N_COUNTERS entries.
+   */
+  void read (uint64_t* values) const;
+
+  /**
+   * @returns a short name for counter \p c.
+   */
+  static const char* name (const Counter c);
+
+ private:
+
+  /**
+   * File descriptors of the counters; the first one leads the group.
+   */
+  int _fd[N_COUNTERS];
+
+  bool _available;
+
+  // Counters are tied to file descriptors, so copying is not allowed.
+  HardwareCounters (const HardwareCounters&);
+  HardwareCounters& operator= (const HardwareCounters&);
+};
+
+
+
 class PerfMon
 {
  public:
@@ -65,6 +143,9 @@ class PerfMon
   float rtime, ptime, mflops;
   long long int flpins;
 #endif
+
+  HardwareCounters counters;
+  uint64_t counts_start[HardwareCounters::N_COUNTERS];
 };
 
 
@@ -78,6 +159,8 @@ PerfMon::reset ()
 #ifdef HAVE_PAPI_H
   Papi::PAPI_flops (&rtime, &ptime, &flpins, &mflops);
 #endif
+
+  counters.read (counts_start);
 }
 
 
@@ -92,6 +175,9 @@ PerfMon::print (std::string msg, std::ostream &out)
   Papi::PAPI_flops (&rtime, &ptime, &flpins, &mflops);
 #endif
 
+  uint64_t counts[HardwareCounters::N_COUNTERS];
+  counters.read (counts);
+
   const double elapsed_time = ((double) (the_time_stop.tv_sec - the_time_start.tv_sec)) +
                               ((double) (the_time_stop.tv_usec - the_time_start.tv_usec))/1000000.;
 
@@ -125,6 +211,36 @@ PerfMon::print (std::string msg, std::ostream &out)
 
 #endif
 
+	  if (counters.available())
+	    {
+	      const double cycles =
+		static_cast<double>(counts[HardwareCounters::CYCLES] -
+				    counts_start[HardwareCounters::CYCLES]);
+	      const double instructions =
+		static_cast<double>(counts[HardwareCounters::INSTRUCTIONS] -
+				    counts_start[HardwareCounters::INSTRUCTIONS]);
+	      const double references =
+		static_cast<double>(counts[HardwareCounters::CACHE_REFERENCES] -
+				    counts_start[HardwareCounters::CACHE_REFERENCES]);
+	      const double misses =
+		static_cast<double>(counts[HardwareCounters::CACHE_MISSES] -
+				    counts_start[HardwareCounters::CACHE_MISSES]);
+	      const double branch_misses =
+		static_cast<double>(counts[HardwareCounters::BRANCH_MISSES] -
+				    counts_start[HardwareCounters::BRANCH_MISSES]);
+
+	      out << " " << ((msg == "NULL") ? id_string : msg)
+		  << ": cycles: " << cycles
+		  << ", instructions: " << instructions
+		  << ", IPC: " << (cycles > 0. ? instructions/cycles : 0.)
+		  << ", cache miss rate: " << (references > 0. ? misses/references : 0.)
+		  << ", branch misses: " << branch_misses
+		  << ", est. memory bandwidth: "
+		  << (elapsed_time > 0. ?
+		      misses*HardwareCounters::cache_line_size/elapsed_time*1.e-9 : 0.)
+		  << " (GB/s)"
+		  << std::endl;
+	    }
 	}
     }
 
@@ -229,7 +229,10 @@ private:
   char comm[xdr_MAX_STRING_LENGTH];
 
   /**
-   * Are we reading/writing zipped files?
+   * Are we reading/writing zipped files?  \p bzipped_file and
+   * \p xzipped_file are only set when the file goes through an
+   * uncompressed temporary file and the external programs, because
+   * libMesh was built without libbz2 or liblzma.
    */
   bool gzipped_file, bzipped_file, xzipped_file;
 